@@ -9,6 +9,30 @@
 #include <deque>
 #include <clocale>
 #include <cctype>
+#include <cstring>
+#include <chrono>
+#include <map>
+#include <csignal>
+#include <cerrno>
+#include <cstdio>
+#include <cstdint>
+#include <climits>
+#include <thread>
+#include <mutex>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <spawn.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "src/game_plugin.h"
+
+extern char** environ;
 
 namespace fs = std::filesystem;
 
@@ -16,6 +40,9 @@ struct Game {
     std::string filename;
     std::string displayName;
     std::string description;
+    std::string tags;
+    long long mtime = 0;  // of the binary, to spot a rebuilt or replaced game
+    long long size = 0;
     bool isFavorite = false;
 };
 
@@ -30,6 +57,42 @@ bool searchMode = false;
 std::string searchQuery = "";
 int currentTab = 0;
 
+// Outcome of the last launch, shown above the footer until the next one.
+std::string statusMessage = "";
+bool statusIsError = false;
+std::map<std::string, double> lastRunSeconds;
+
+// Time from launch to the game's first frame, per launch path, so the
+// paths can be compared side by side.
+enum LaunchPath { PATH_EXEC, PATH_ZYGOTE, PATH_PLUGIN, PATH_COUNT };
+const char* PATH_NAMES[PATH_COUNT] = {"exec", "zygote", "in-process"};
+std::map<std::string, double> firstFrameMs[PATH_COUNT];
+
+// In zygote mode the launcher itself is the zygote: it has already paid for
+// dynamic linking, locale setup and terminfo loading, and it keeps every
+// game's plugin (exec/plugins/<name>.so, the game built with its main()
+// renamed to game_main) loaded and relocated. A launch is then a fork() that
+// jumps straight into the game's entry point.
+//
+// Games that implement the plugin ABI (src/game_plugin.h) skip even the
+// fork: they run inside the launcher, on windows it hands them, and are
+// reloaded when their plugin file is rebuilt.
+bool zygoteMode = false;
+const std::string PLUGIN_DIR = "./exec/plugins";
+
+struct Plugin {
+    void* handle = nullptr;
+    int (*mainArgs)(int, char**) = nullptr;
+    int (*mainNoArgs)() = nullptr;
+    const GamePlugin* api = nullptr;
+    long long mtime = 0;
+};
+std::map<std::string, Plugin> plugins;
+// Plugins that dlclose left mapped; opening them again would only hand back
+// the old code, so they are not loaded again this session.
+std::set<std::string> pinnedPlugins;
+std::string pluginError;  // why the last loadPlugin() returned nullptr
+
 const char* DATA_FILE = "launcher.dat";
 const std::string EXEC_DIR = "./exec";
 
@@ -46,40 +109,48 @@ int utf8_visual_length(const std::string& str) {
     return length;
 }
 
-void enrichGameData(Game& g) {
-    if (g.filename == "snake") { 
-        g.displayName = "SNAKE"; 
-        g.description = "Classic Snake game. Eat apples, don't hit walls."; 
-    }
-    else if (g.filename == "2048") { 
-        g.displayName = "2048"; 
-        g.description = "Join the numbers and get to the 2048 tile!"; 
-    }
-    else if (g.filename == "minesweeper") { 
-        g.displayName = "MINESWEEPER"; 
-        g.description = "Find mines using logic and flood fill."; 
-    }
-    else if (g.filename == "tetris") { 
-        g.displayName = "TETRIS"; 
-        g.description = "Stack blocks and clear lines before it's too late."; 
-    }
-    else if (g.filename == "sudoku") { 
-        g.displayName = "SUDOKU"; 
-        g.description = "Logic puzzle. Fill the grid with numbers 1-9."; 
-    }
-    else if (g.filename == "tic-tac-toe" || g.filename == "tictactoe") {
-        g.displayName = "TIC-TAC-TOE";
-        g.description = "Classic X's and O's. Get three in a row to win!";
-    }
-    else if (g.filename == "pacman" || g.filename == "tictactoe") {
-        g.displayName = "PAC-MAN";
-        g.description = "Navigate the maze, eat pellets, and avoid ghosts!";
+std::vector<std::string> splitWords(const std::string& text) {
+    std::vector<std::string> words;
+    std::string word;
+    for (char c : text) {
+        if (c != ' ') { word += c; continue; }
+        if (!word.empty()) words.push_back(word);
+        word.clear();
     }
-    else {
-        g.displayName = g.filename;
-        std::transform(g.displayName.begin(), g.displayName.end(), g.displayName.begin(), ::toupper);
-        g.description = "Unknown game executable.";
+    if (!word.empty()) words.push_back(word);
+    return words;
+}
+
+struct GameInfo {
+    const char* filename;
+    const char* displayName;
+    const char* description;
+    const char* tags;
+};
+
+const GameInfo KNOWN_GAMES[] = {
+    {"snake", "SNAKE", "Classic Snake game. Eat apples, don't hit walls.", "arcade classic"},
+    {"2048", "2048", "Join the numbers and get to the 2048 tile!", "puzzle numbers"},
+    {"minesweeper", "MINESWEEPER", "Find mines using logic and flood fill.", "puzzle logic"},
+    {"tetris", "TETRIS", "Stack blocks and clear lines before it's too late.", "arcade classic"},
+    {"sudoku", "SUDOKU", "Logic puzzle. Fill the grid with numbers 1-9.", "puzzle logic numbers"},
+    {"tic-tac-toe", "TIC-TAC-TOE", "Classic X's and O's. Get three in a row to win!", "strategy two-player"},
+    {"tictactoe", "TIC-TAC-TOE", "Classic X's and O's. Get three in a row to win!", "strategy two-player"},
+    {"pacman", "PAC-MAN", "Navigate the maze, eat pellets, and avoid ghosts!", "arcade classic"},
+};
+
+void enrichGameData(Game& g) {
+    for (const auto& info : KNOWN_GAMES) {
+        if (g.filename != info.filename) continue;
+        g.displayName = info.displayName;
+        g.description = info.description;
+        g.tags = info.tags;
+        return;
     }
+    g.displayName = g.filename;
+    std::transform(g.displayName.begin(), g.displayName.end(), g.displayName.begin(), ::toupper);
+    g.description = "Unknown game executable.";
+    g.tags = "";
 }
 
 void saveData() {
@@ -112,63 +183,847 @@ void loadData() {
     f.close();
 }
 
-void scanGames() {
-    allGames.clear();
-    if (!fs::exists(EXEC_DIR)) fs::create_directory(EXEC_DIR);
+// The game list is cached in a small binary manifest, so the launcher shows
+// it at once on start, before ./exec has been looked at. A header is followed
+// by one record per game, each with its filename appended. Only what
+// identifies the executable is cached: the display name, description and
+// tags are always filled in from KNOWN_GAMES on load, so a launcher built
+// with an edited table never shows the old text.
+const char* MANIFEST_FILE = "launcher.manifest";
+const char MANIFEST_MAGIC[8] = {'L', 'N', 'C', 'H', 'M', 'N', 'F', 'T'};
+const uint32_t MANIFEST_VERSION = 2;
+
+struct ManifestHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t count;
+};
 
-    for (const auto& entry : fs::directory_iterator(EXEC_DIR)) {
-        if (entry.is_directory()) continue;
+struct ManifestRecord {
+    int64_t mtime;
+    int64_t size;
+    uint16_t nameLength;
+};
 
-        std::string fname = entry.path().filename().string();
-        if (fname[0] == '.') continue;
-        if (fname.length() > 2 && fname.substr(fname.length()-2) == ".o") continue;
+std::vector<Game> loadManifest() {
+    std::vector<Game> games;
+    std::ifstream in(MANIFEST_FILE, std::ios::binary);
+    ManifestHeader header;
+    if (!in.read((char*)&header, sizeof(header))) return games;
+    if (memcmp(header.magic, MANIFEST_MAGIC, sizeof(MANIFEST_MAGIC)) != 0 || header.version != MANIFEST_VERSION)
+        return games;
 
+    for (uint32_t i = 0; i < header.count; i++) {
+        ManifestRecord rec;
+        if (!in.read((char*)&rec, sizeof(rec))) return {};
         Game g;
-        g.filename = fname;
+        g.mtime = rec.mtime;
+        g.size = rec.size;
+        g.filename.resize(rec.nameLength);
+        if (!in.read(&g.filename[0], rec.nameLength)) return {};
         enrichGameData(g);
-        allGames.push_back(g);
+        games.push_back(g);
     }
+    return games;
 }
 
-void filterGames() {
-    visibleGames.clear();
-    for (auto& g : allGames) {
-        g.isFavorite = (favorites.find(g.filename) != favorites.end());
+void saveManifest(const std::vector<Game>& games) {
+    ManifestHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MANIFEST_MAGIC, sizeof(MANIFEST_MAGIC));
+    header.version = MANIFEST_VERSION;
+    header.count = games.size();
 
-        if (currentTab == 1 && !g.isFavorite) continue;
-        if (currentTab == 2) {
-            bool isRecent = false;
-            for(auto& r : recents) if(r == g.filename) isRecent = true;
-            if(!isRecent) continue;
+    // Written aside and renamed, so a launcher starting mid-save never sees
+    // half a file.
+    std::string tmp = std::string(MANIFEST_FILE) + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out) return;
+        out.write((const char*)&header, sizeof(header));
+        for (const auto& g : games) {
+            ManifestRecord rec = {};
+            rec.mtime = g.mtime;
+            rec.size = g.size;
+            rec.nameLength = std::min<size_t>(g.filename.size(), UINT16_MAX);
+            out.write((const char*)&rec, sizeof(rec));
+            out.write(g.filename.data(), rec.nameLength);
         }
+        if (!out) return;
+    }
+    std::rename(tmp.c_str(), MANIFEST_FILE);
+}
 
-        if (!searchQuery.empty()) {
-            std::string nameLower = g.displayName;
-            std::string queryLower = searchQuery;
-            
-            std::transform(nameLower.begin(), nameLower.end(), nameLower.begin(), 
-                           [](unsigned char c){ return std::tolower(c); });
-            std::transform(queryLower.begin(), queryLower.end(), queryLower.begin(), 
-                           [](unsigned char c){ return std::tolower(c); });
-            
-            if (nameLower.find(queryLower) == std::string::npos) continue;
+// Keeps the manifest in step with ./exec on a background thread, so the UI
+// never waits on the filesystem. The directory is scanned once at start and
+// then watched with inotify; each event re-examines just the file it names,
+// and only a changed mtime or size re-reads a game's metadata. Where
+// inotify is unavailable (or its queue overflows) the thread falls back to
+// full rescans. Each change publishes a fresh snapshot that the UI thread
+// picks up between keys.
+const int MANIFEST_RESCAN_MS = 2000;
+const int MANIFEST_POLL_MS = 200;
+
+struct ManifestWatcher {
+    std::thread thread;
+    int stopPipe[2] = {-1, -1};
+
+    std::mutex mutex;
+    std::vector<Game> snapshot;  // guarded by mutex
+    bool fresh = false;          // guarded by mutex
+
+    std::map<std::string, Game> entries;  // owned by the thread
+
+    static bool listed(const std::string& name) {
+        if (name.empty() || name[0] == '.') return false;
+        return !(name.length() > 2 && name.substr(name.length() - 2) == ".o");
+    }
+
+    // Re-examines one directory entry; true if the list changed.
+    bool update(const std::string& name) {
+        if (!listed(name)) return false;
+        struct stat st;
+        std::string path = EXEC_DIR + "/" + name;
+        if (stat(path.c_str(), &st) != 0 || S_ISDIR(st.st_mode)) return entries.erase(name) > 0;
+
+        long long mtime = (long long)st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+        auto it = entries.find(name);
+        if (it != entries.end() && it->second.mtime == mtime && it->second.size == (long long)st.st_size) return false;
+
+        Game g;
+        g.filename = name;
+        g.mtime = mtime;
+        g.size = st.st_size;
+        enrichGameData(g);
+        entries[name] = g;
+        return true;
+    }
+
+    bool rescan() {
+        bool changed = false;
+        std::set<std::string> seen;
+        std::error_code ec;
+        for (fs::directory_iterator it(EXEC_DIR, ec), end; !ec && it != end; it.increment(ec)) {
+            std::string name = it->path().filename().string();
+            seen.insert(name);
+            changed |= update(name);
+        }
+        for (auto it = entries.begin(); it != entries.end();) {
+            if (seen.count(it->first)) { ++it; continue; }
+            it = entries.erase(it);
+            changed = true;
         }
+        return changed;
+    }
 
-        visibleGames.push_back(&g);
+    void publish() {
+        std::vector<Game> games;
+        games.reserve(entries.size());
+        for (const auto& e : entries) games.push_back(e.second);
+        saveManifest(games);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        snapshot.swap(games);
+        fresh = true;
     }
-    
-    if (currentTab == 2) {
-        std::sort(visibleGames.begin(), visibleGames.end(), [](Game* a, Game* b){
-            auto itA = std::find(recents.begin(), recents.end(), a->filename);
-            auto itB = std::find(recents.begin(), recents.end(), b->filename);
-            return std::distance(recents.begin(), itA) < std::distance(recents.begin(), itB);
+
+    void run() {
+        // The watch goes in before the first scan, so nothing that changes
+        // while the scan runs is missed.
+        int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        uint32_t mask = IN_CREATE | IN_DELETE | IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO | IN_ATTRIB |
+                        IN_DELETE_SELF | IN_MOVE_SELF;
+        if (fd >= 0 && inotify_add_watch(fd, EXEC_DIR.c_str(), mask) < 0) {
+            close(fd);
+            fd = -1;
+        }
+        if (rescan()) publish();
+
+        alignas(struct inotify_event) char buf[16384];
+        while (true) {
+            struct pollfd fds[2] = {{stopPipe[0], POLLIN, 0}, {fd, POLLIN, 0}};
+            if (poll(fds, fd >= 0 ? 2 : 1, fd >= 0 ? -1 : MANIFEST_RESCAN_MS) < 0 && errno != EINTR) break;
+            if (fds[0].revents) break;
+            if (fd < 0) {
+                if (rescan()) publish();
+                continue;
+            }
+
+            bool changed = false, full = false;
+            ssize_t len;
+            while ((len = read(fd, buf, sizeof(buf))) > 0) {
+                for (char* p = buf; p < buf + len;) {
+                    auto* ev = (struct inotify_event*)p;
+                    if (ev->mask & (IN_Q_OVERFLOW | IN_DELETE_SELF | IN_MOVE_SELF)) full = true;
+                    else if (ev->len > 0) changed |= update(ev->name);
+                    p += sizeof(struct inotify_event) + ev->len;
+                }
+            }
+            if (full) changed |= rescan();
+            if (changed) publish();
+        }
+        if (fd >= 0) close(fd);
+    }
+
+    void start(const std::vector<Game>& cached) {
+        for (const auto& g : cached) entries[g.filename] = g;
+        if (pipe2(stopPipe, O_CLOEXEC) != 0) stopPipe[0] = stopPipe[1] = -1;
+        thread = std::thread([this] { run(); });
+    }
+
+    void stop() {
+        if (!thread.joinable()) return;
+        char c = 0;
+        if (write(stopPipe[1], &c, 1) == 1) thread.join();
+        else thread.detach();
+    }
+
+    // Swaps the latest snapshot into `games`; false if nothing new.
+    bool take(std::vector<Game>& games) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!fresh) return false;
+        games.swap(snapshot);
+        fresh = false;
+        return true;
+    }
+};
+
+// Never destroyed: a zygote child leaves through exit(), and destroying a
+// joinable std::thread there would abort it.
+ManifestWatcher* watcher = new ManifestWatcher();
+
+// Search is fuzzy, in the style of fzf: the query's characters must appear
+// in order, and a match scores higher when they are consecutive, start words
+// or start the name. Names are matched first; a game whose name does not
+// match can still be found through its description and tags, ranked below
+// every name match.
+//
+// Every game is lowercased once into an index entry, along with a bitmask of
+// the characters it contains, so most non-matches are rejected with one AND.
+// Results are kept per query prefix: typing a character only re-scores the
+// previous result set, and backspace just drops the last level.
+const int SCORE_MATCH = 16;
+const int SCORE_GAP_START = -3;
+const int SCORE_GAP_EXTENSION = -1;
+const int BONUS_BOUNDARY = 8;
+const int BONUS_CONSECUTIVE = 4;
+const int BONUS_FIRST_CHAR_MULTIPLIER = 2;
+const int NO_MATCH = INT_MIN;
+
+struct SearchEntry {
+    Game* game;
+    std::string name;  // lowercased displayName
+    std::string text;  // lowercased description and tags
+    uint64_t nameChars, textChars;
+    int recent = -1;   // position in recents, or -1; see rankRecents()
+};
+
+struct SearchHit {
+    int entry;
+    int score;
+    int end;              // where the match ends; see matchEnd()
+    uint16_t nameLength;  // copied from the entry, so ranking reads only hits
+    bool inText;          // matched the description or tags, not the name
+};
+
+// One level per query prefix. Hits stay in index order, so every query
+// yields the same ranking however it was typed; `ranked` is the display
+// order, built when the level is first shown.
+struct SearchLevel {
+    std::vector<SearchHit> hits;
+    std::vector<int> ranked;
+    bool isRanked = false;
+};
+
+std::vector<SearchEntry> searchIndex;
+std::string indexedQuery = "";
+std::vector<SearchLevel> searchLevels;  // one per prefix of indexedQuery
+
+// The Recents tab needs each game's position in `recents`. It is kept in the
+// index entries and worked out again only when that tab is filtered after
+// the list or the index has changed, so a keystroke tests one int per hit.
+std::deque<std::string> rankedRecents;
+bool recentsRanked = false;
+
+uint64_t charBit(unsigned char c) {
+    if (c >= 'a' && c <= 'z') return 1ULL << (c - 'a');
+    if (c >= '0' && c <= '9') return 1ULL << (26 + c - '0');
+    return 1ULL << (36 + c % 28);
+}
+
+uint64_t charMask(const std::string& s) {
+    uint64_t mask = 0;
+    for (unsigned char c : s) mask |= charBit(c);
+    return mask;
+}
+
+std::string toLower(std::string s) {
+    std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c){ return std::tolower(c); });
+    return s;
+}
+
+// Index of the last character of the first occurrence of `query` as a
+// subsequence of `text`, or -1. Scanning is greedy, so the end for a longer
+// query is the next occurrence of its last character after this one: a
+// search level resumes from here rather than scanning its prefix again.
+int matchEnd(const std::string& text, const std::string& query) {
+    const char* t = text.data();
+    const char* p = t - 1;
+    const char* limit = t + text.size();
+    for (char c : query) {
+        p = (const char*)memchr(p + 1, c, limit - p - 1);
+        if (!p) return -1;
+    }
+    return p - t;
+}
+
+// Scores the match of `query` in `text` (both lowercase) that ends at `end`,
+// as found by matchEnd(). A backward pass from there picks the shortest
+// window, as fzf's v1 matcher does. Only matched characters and gap lengths
+// are looked at, so the cost grows with the query, not the text. Matched
+// positions go to `positions` when given.
+int scoreMatch(const std::string& text, const std::string& query, int end, std::vector<int>* positions = nullptr) {
+    static std::vector<int> scratch;
+    std::vector<int>& pos = positions ? *positions : scratch;
+    int m = query.size();
+    if (m == 0) return 0;
+
+    const char* t = text.data();
+    pos.resize(m);
+    int i = end;
+    for (int q = m - 1; q >= 0; q--, i--) {
+        while (t[i] != query[q]) i--;
+        pos[q] = i;
+    }
+
+    int score = 0;
+    for (int q = 0; q < m; q++) {
+        int at = pos[q];
+        bool boundary = at == 0 || !isalnum((unsigned char)t[at - 1]);
+        bool consecutive = q > 0 && pos[q - 1] == at - 1;
+        int bonus = boundary ? BONUS_BOUNDARY : 0;
+        if (consecutive) bonus = std::max(bonus, BONUS_CONSECUTIVE);
+        score += SCORE_MATCH + (q == 0 ? bonus * BONUS_FIRST_CHAR_MULTIPLIER : bonus);
+        int gap = q > 0 ? at - pos[q - 1] - 1 : 0;
+        if (gap > 0) score += SCORE_GAP_START + (gap - 1) * SCORE_GAP_EXTENSION;
+    }
+    return score;
+}
+
+// Scores `query` as a subsequence of `text`; NO_MATCH if it is not one.
+int fuzzyScore(const std::string& text, const std::string& query, std::vector<int>* positions = nullptr) {
+    int end = matchEnd(text, query);
+    return end < 0 ? NO_MATCH : scoreMatch(text, query, end, positions);
+}
+
+void buildSearchIndex() {
+    searchIndex.clear();
+    searchIndex.reserve(allGames.size());
+    for (auto& g : allGames) {
+        g.isFavorite = favorites.count(g.filename) > 0;
+        SearchEntry e;
+        e.game = &g;
+        e.name = toLower(g.displayName);
+        e.text = toLower(g.description + " " + g.tags);
+        e.nameChars = charMask(e.name);
+        e.textChars = charMask(e.text);
+        searchIndex.push_back(std::move(e));
+    }
+
+    SearchLevel all;
+    all.hits.resize(searchIndex.size());
+    for (size_t i = 0; i < all.hits.size(); i++) all.hits[i] = {(int)i, 0, -1, (uint16_t)searchIndex[i].name.size(), false};
+    searchLevels.assign(1, std::move(all));
+    indexedQuery.clear();
+    recentsRanked = false;
+}
+
+// Orders a level: name matches first, then description and tag matches,
+// each by score and then by shorter name. The two tiers' scores are not
+// comparable, so each gets its own run of (score, length) buckets spanning
+// just its own score range, tier 1's after tier 0's. The ranges are narrow,
+// so this is normally one counting sort, which keeps index order within a
+// bucket; widely spread scores fall back to a stable comparison sort with
+// the same result.
+void rankLevel(SearchLevel& level) {
+    static std::vector<int> start;
+    const auto& hits = level.hits;
+    level.ranked.resize(hits.size());
+    level.isRanked = true;
+    if (hits.empty()) return;
+
+    int best[2] = {INT_MIN, INT_MIN}, worst[2] = {INT_MAX, INT_MAX};
+    int shortest = INT_MAX, longest = 0;
+    for (const auto& h : hits) {
+        best[h.inText] = std::max(best[h.inText], h.score);
+        worst[h.inText] = std::min(worst[h.inText], h.score);
+        shortest = std::min(shortest, (int)h.nameLength);
+        longest = std::max(longest, (int)h.nameLength);
+    }
+    size_t lengths = longest - shortest + 1;
+    size_t base[2] = {0, 0};
+    size_t buckets = 0;
+    for (int t = 0; t < 2; t++) {
+        base[t] = buckets;
+        if (best[t] != INT_MIN) buckets += (size_t)((int64_t)best[t] - worst[t] + 1) * lengths;
+    }
+
+    if (buckets > 4 * hits.size() + 1024) {
+        for (size_t i = 0; i < hits.size(); i++) level.ranked[i] = i;
+        std::stable_sort(level.ranked.begin(), level.ranked.end(), [&](int a, int b) {
+            if (hits[a].inText != hits[b].inText) return hits[b].inText;
+            if (hits[a].score != hits[b].score) return hits[a].score > hits[b].score;
+            return hits[a].nameLength < hits[b].nameLength;
         });
+    } else {
+        auto bucketOf = [&](const SearchHit& h) {
+            return base[h.inText] + (size_t)(best[h.inText] - h.score) * lengths + (h.nameLength - shortest);
+        };
+        start.assign(buckets + 1, 0);
+        for (const auto& h : hits) start[bucketOf(h) + 1]++;
+        for (size_t b = 0; b < buckets; b++) start[b + 1] += start[b];
+        for (size_t i = 0; i < hits.size(); i++) level.ranked[start[bucketOf(hits[i])]++] = i;
     }
+    for (auto& r : level.ranked) r = hits[r].entry;
+}
+
+// Extends a match ending at `end` by the character `c`; -1 if it cannot be.
+int resumeMatch(const std::string& text, char c, int end) {
+    const char* t = text.data();
+    const char* p = (const char*)memchr(t + end + 1, c, text.size() - end - 1);
+    return p ? p - t : -1;
+}
+
+// Returns index entries in display order.
+const std::vector<int>& searchGames(const std::string& query) {
+    size_t keep = 0;
+    while (keep < query.size() && keep < indexedQuery.size() && query[keep] == indexedQuery[keep]) keep++;
+    searchLevels.resize(keep + 1);
+    indexedQuery = query.substr(0, keep);
+
+    while (indexedQuery.size() < query.size()) {
+        indexedQuery += query[indexedQuery.size()];
+        uint64_t need = charMask(indexedQuery);
+        char c = indexedQuery.back();
+        SearchLevel next;
+        next.hits.reserve(searchLevels.back().hits.size());
+        for (const auto& hit : searchLevels.back().hits) {
+            const SearchEntry& e = searchIndex[hit.entry];
+            // A name that missed the shorter query misses this one too.
+            int end = -1;
+            bool inText = hit.inText;
+            if (!inText && (e.nameChars & need) == need) end = resumeMatch(e.name, c, hit.end);
+            if (end < 0 && (e.textChars & need) == need) {
+                end = inText ? resumeMatch(e.text, c, hit.end) : matchEnd(e.text, indexedQuery);
+                inText = true;
+            }
+            if (end < 0) continue;
+            int score = scoreMatch(inText ? e.text : e.name, indexedQuery, end);
+            next.hits.push_back({hit.entry, score, end, hit.nameLength, inText});
+        }
+        searchLevels.push_back(std::move(next));
+    }
+
+    // With no query the list keeps the index order (by filename).
+    SearchLevel& level = searchLevels.back();
+    if (!level.isRanked && query.empty()) {
+        level.ranked.resize(level.hits.size());
+        for (size_t i = 0; i < level.hits.size(); i++) level.ranked[i] = level.hits[i].entry;
+        level.isRanked = true;
+    }
+    if (!level.isRanked) rankLevel(level);
+    return level.ranked;
+}
+
+// Sets each index entry's position in `recents` for the Recents tab.
+void rankRecents() {
+    std::map<std::string, int> recentRank;
+    for (size_t i = 0; i < recents.size(); i++) recentRank.emplace(recents[i], i);
+    for (auto& e : searchIndex) {
+        auto it = recentRank.find(e.game->filename);
+        e.recent = it == recentRank.end() ? -1 : it->second;
+    }
+    rankedRecents = recents;
+    recentsRanked = true;
+}
+
+void filterGames() {
+    visibleGames.clear();
+
+    const std::vector<int>& entries = searchGames(toLower(searchQuery));
+
+    if (currentTab == 2 && (!recentsRanked || recents != rankedRecents)) rankRecents();
+
+    // Recents are few, so they are placed straight into their slots.
+    std::vector<Game*> byRecent(currentTab == 2 ? recents.size() : 0, nullptr);
+    visibleGames.reserve(entries.size());
+    for (int entry : entries) {
+        const SearchEntry& e = searchIndex[entry];
+        if (currentTab == 1 && !e.game->isFavorite) continue;
+        if (currentTab == 2) {
+            if (e.recent >= 0) byRecent[e.recent] = e.game;
+            continue;
+        }
+        visibleGames.push_back(e.game);
+    }
+    for (Game* g : byRecent)
+        if (g) visibleGames.push_back(g);
 
     if (visibleGames.empty()) selectedIdx = 0;
     else if (selectedIdx >= (int)visibleGames.size()) selectedIdx = 0;
 }
 
+// Draws a game name with the characters the search matched in bold.
+void printMatched(int y, int x, const std::string& name) {
+    std::vector<int> positions;
+    std::string query = toLower(searchQuery);
+    if (query.empty() || fuzzyScore(toLower(name), query, &positions) == NO_MATCH) {
+        mvprintw(y, x, "%s", name.c_str());
+        return;
+    }
+    attr_t attrs;
+    short pair;
+    attr_get(&attrs, &pair, nullptr);
+    size_t next = 0;
+    for (size_t i = 0; i < name.size(); i++) {
+        bool hit = next < positions.size() && positions[next] == (int)i;
+        if (hit) { attron(A_BOLD | A_UNDERLINE); next++; }
+        mvaddch(y, x + i, (unsigned char)name[i]);
+        if (hit) attr_set(attrs, pair, nullptr);
+    }
+}
+
+std::string pluginPath(const std::string& filename) {
+    return PLUGIN_DIR + "/" + filename + ".so";
+}
+
+// Nanoseconds since the epoch, 0 when the file is missing.
+long long fileMtime(const std::string& path) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) return 0;
+    return (long long)st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+}
+
+// Plugins are built with -fno-gnu-unique so that dlclose can unmap them and
+// the next loadPlugin picks up a rebuilt file. A plugin can still be pinned
+// (glibc keeps an object mapped while a thread holds a thread_local
+// destructor from it), so RTLD_NOLOAD checks that it is really gone.
+void unloadPlugin(const std::string& filename) {
+    auto it = plugins.find(filename);
+    if (it == plugins.end()) return;
+    if (it->second.handle) dlclose(it->second.handle);
+    plugins.erase(it);
+    if (void* still = dlopen(pluginPath(filename).c_str(), RTLD_NOW | RTLD_NOLOAD)) {
+        dlclose(still);
+        pinnedPlugins.insert(filename);
+    }
+}
+
+// Games declare main() either with or without arguments, so game_main is
+// looked up under both C++ mangled names. A loaded plugin whose file has
+// changed since is unloaded and opened again; a file that fails to load is
+// not remembered, so it is tried again on the next lookup.
+Plugin* loadPlugin(const std::string& filename) {
+    std::string path = pluginPath(filename);
+    long long mtime = fileMtime(path);
+    auto it = plugins.find(filename);
+    if (it != plugins.end()) {
+        if (it->second.mtime == mtime) return &it->second;
+        unloadPlugin(filename);
+    }
+    if (pinnedPlugins.count(filename)) {
+        pluginError = "the old plugin is still mapped; restart the launcher to load the new one";
+        return nullptr;
+    }
+
+    Plugin p;
+    p.mtime = mtime;
+    p.handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!p.handle) {
+        const char* err = dlerror();
+        pluginError = err ? err : "cannot open " + path;
+        return nullptr;
+    }
+    p.mainArgs = (int (*)(int, char**))dlsym(p.handle, "_Z9game_mainiPPc");
+    p.mainNoArgs = (int (*)())dlsym(p.handle, "_Z9game_mainv");
+    auto entry = (const GamePlugin* (*)())dlsym(p.handle, "game_plugin");
+    if (entry && entry()->abiVersion == GAME_PLUGIN_ABI_VERSION) p.api = entry();
+    if (!p.mainArgs && !p.mainNoArgs && !p.api) {
+        dlclose(p.handle);
+        pluginError = "no game entry point";
+        return nullptr;
+    }
+    return &(plugins[filename] = p);
+}
+
+void preloadPlugins() {
+    for (const auto& g : allGames) loadPlugin(g.filename);
+}
+
+// Reads the bytes the child has written so far from /proc; -1 where that is
+// not available.
+long long bytesWritten(pid_t pid) {
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/io", (int)pid);
+    FILE* f = fopen(path, "r");
+    if (!f) return -1;
+    long long value = -1;
+    char key[32];
+    long long n;
+    while (fscanf(f, "%31[^:]: %lld\n", key, &n) == 2) {
+        if (strcmp(key, "wchar") == 0) { value = n; break; }
+    }
+    fclose(f);
+    return value;
+}
+
+const long FIRST_FRAME_POLL_MIN_NS = 100 * 1000;
+const long FIRST_FRAME_POLL_MAX_NS = 1000 * 1000;
+
+// Waits for the child. Until its first write (its first frame) it checks
+// /proc between short sleeps, to time that moment; -1 when it could not be
+// seen. The sleeps start at 100 us, so fast starts are timed closely, and
+// grow to 1 ms, so a slow start is not slowed further by the launcher
+// competing for the CPU. A pidfd, where the kernel has them, ends the
+// sleep as soon as the child exits.
+int waitForGame(pid_t pid, std::chrono::steady_clock::time_point start, double& firstFrame) {
+    int status = 0;
+    firstFrame = -1;
+#ifdef SYS_pidfd_open
+    int pidfd = syscall(SYS_pidfd_open, pid, 0);
+#else
+    int pidfd = -1;
+#endif
+    long sleepNs = FIRST_FRAME_POLL_MIN_NS;
+    bool reaped = false;
+    while (!reaped) {
+        long long written = bytesWritten(pid);
+        if (written < 0) break;
+        if (written > 0) {
+            firstFrame = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            break;
+        }
+        struct timespec wait = {0, sleepNs};
+        if (pidfd >= 0) {
+            struct pollfd fd = {pidfd, POLLIN, 0};
+            ppoll(&fd, 1, &wait, nullptr);
+        } else {
+            nanosleep(&wait, nullptr);
+        }
+        sleepNs = std::min(sleepNs * 3 / 2, FIRST_FRAME_POLL_MAX_NS);
+        pid_t r = waitpid(pid, &status, WNOHANG);
+        reaped = r == pid || (r < 0 && errno != EINTR);
+    }
+    if (pidfd >= 0) close(pidfd);
+    if (!reaped) while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+    return status;
+}
+
+pid_t forkGame(Plugin* p, const std::string& filename) {
+    pid_t pid = fork();
+    if (pid != 0) return pid;
+
+    signal(SIGINT, SIG_DFL);
+    signal(SIGQUIT, SIG_DFL);
+    // The game's initscr() finds curses already set up and reuses it; drop
+    // the launcher's screen contents so nothing of it leaks into the game.
+    erase();
+    std::string path = EXEC_DIR + "/" + filename;
+    char* argv[] = {const_cast<char*>(path.c_str()), nullptr};
+    exit(p->mainArgs ? p->mainArgs(1, argv) : p->mainNoArgs());
+}
+
+void reportRun(Game* g, LaunchPath via, int err, int status, double seconds, double firstFrame) {
+    char buf[160];
+    statusIsError = true;
+    if (err != 0) {
+        snprintf(buf, sizeof(buf), "Could not start %s: %s", g->displayName.c_str(), strerror(err));
+    } else if (WIFSIGNALED(status)) {
+        snprintf(buf, sizeof(buf), "%s crashed after %.1f s: %s%s", g->displayName.c_str(), seconds,
+                 strsignal(WTERMSIG(status)), WCOREDUMP(status) ? " (core dumped)" : "");
+    } else if (WEXITSTATUS(status) != 0) {
+        snprintf(buf, sizeof(buf), "%s exited with status %d after %.1f s", g->displayName.c_str(),
+                 WEXITSTATUS(status), seconds);
+    } else if (firstFrame >= 0) {
+        snprintf(buf, sizeof(buf), "%s: first frame %.1f ms via %s, played %.1f s", g->displayName.c_str(),
+                 firstFrame, PATH_NAMES[via], seconds);
+        statusIsError = false;
+    } else {
+        snprintf(buf, sizeof(buf), "%s: played %.1f s", g->displayName.c_str(), seconds);
+        statusIsError = false;
+    }
+    statusMessage = buf;
+    if (err == 0) lastRunSeconds[g->filename] = seconds;
+    if (firstFrame >= 0) firstFrameMs[via][g->filename] = firstFrame;
+}
+
+void initColors() {
+    if (!has_colors()) return;
+    init_pair(1, COLOR_CYAN, COLOR_BLACK);
+    init_pair(2, COLOR_GREEN, COLOR_BLACK);
+    init_pair(3, COLOR_RED, COLOR_BLACK);
+    init_pair(4, COLOR_YELLOW, COLOR_BLACK);
+    init_pair(5, COLOR_BLUE, COLOR_BLACK);
+}
+
+// Runs a child process on the terminal: the game's own binary, or a fork of
+// the launcher when zygote mode has its plugin.
+void runChild(Game* g, Plugin* plugin) {
+    // The child gets the terminal in the mode the shell left it in; ours is
+    // put back with a single tcsetattr afterwards, even if the game died
+    // with the terminal still raw, and the screen is repainted once.
+    struct termios progMode;
+    bool haveProgMode = tcgetattr(STDIN_FILENO, &progMode) == 0;
+    endwin();
+
+    // Like system(), ignore ^C and ^\ while the game owns the terminal; the
+    // child gets the default handlers back.
+    struct sigaction ignore = {}, oldInt, oldQuit;
+    ignore.sa_handler = SIG_IGN;
+    sigemptyset(&ignore.sa_mask);
+    sigaction(SIGINT, &ignore, &oldInt);
+    sigaction(SIGQUIT, &ignore, &oldQuit);
+
+    LaunchPath via = plugin ? PATH_ZYGOTE : PATH_EXEC;
+
+    auto start = std::chrono::steady_clock::now();
+    pid_t pid = -1;
+    int err = 0;
+    if (plugin) {
+        pid = forkGame(plugin, g->filename);
+        if (pid < 0) err = errno;
+    } else {
+        posix_spawnattr_t attr;
+        posix_spawnattr_init(&attr);
+        sigset_t defaults;
+        sigemptyset(&defaults);
+        sigaddset(&defaults, SIGINT);
+        sigaddset(&defaults, SIGQUIT);
+        posix_spawnattr_setsigdefault(&attr, &defaults);
+        posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGDEF);
+
+        // Executed directly, so the filename never goes through a shell.
+        std::string path = EXEC_DIR + std::string("/") + g->filename;
+        char* argv[] = {const_cast<char*>(path.c_str()), nullptr};
+        err = posix_spawn(&pid, path.c_str(), nullptr, &attr, argv, environ);
+        posix_spawnattr_destroy(&attr);
+    }
+
+    int status = 0;
+    double firstFrame = -1;
+    if (err == 0) status = waitForGame(pid, start, firstFrame);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    sigaction(SIGINT, &oldInt, nullptr);
+    sigaction(SIGQUIT, &oldQuit, nullptr);
+    if (haveProgMode) tcsetattr(STDIN_FILENO, TCSADRAIN, &progMode);
+    clearok(curscr, TRUE);
+
+    reportRun(g, via, err, status, seconds, firstFrame);
+}
+
+const int PLUGIN_POLL_MS = 250;
+
+// Runs a plugin inside the launcher: the game draws into a window covering
+// all but the last line, which the launcher keeps for its own status bar.
+// F10 returns to the launcher from any screen. While the game runs, the
+// plugin file is checked for changes; a rebuilt plugin is reloaded once its
+// mtime has held still for one poll (so a half-written file is never
+// opened) and restarts from init(). A reload that fails ends the session
+// like F10 does, with the reason on the launcher's status bar.
+void runInProcess(Game* g, Plugin* plugin) {
+    std::string filename = g->filename;
+    std::string path = pluginPath(filename);
+    const GamePlugin* api = plugin->api;
+
+    WINDOW* win = newwin(LINES - 1, COLS, 0, 0);
+    WINDOW* bar = newwin(1, COLS, LINES - 1, 0);
+    keypad(win, TRUE);
+    std::string barText = std::string(api->name) + "  |  [F10] Back to launcher";
+    bool barIsError = false;
+
+    auto start = std::chrono::steady_clock::now();
+    auto nextPoll = start + std::chrono::milliseconds(PLUGIN_POLL_MS);
+    long long pendingMtime = 0;
+    double firstFrame = -1;
+    std::string reloadError;
+
+    TickClock clock;
+    api->init();
+    clock.sync(api);
+    clearok(curscr, TRUE);
+    while (true) {
+        api->render(win);
+        werase(bar);
+        wattron(bar, COLOR_PAIR(barIsError ? 3 : 5) | A_REVERSE);
+        mvwprintw(bar, 0, 0, " %-*s", COLS - 1, barText.c_str());
+        wattroff(bar, COLOR_PAIR(barIsError ? 3 : 5) | A_REVERSE);
+        wnoutrefresh(win);
+        wnoutrefresh(bar);
+        doupdate();
+        if (firstFrame < 0)
+            firstFrame = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        auto now = std::chrono::steady_clock::now();
+        int waitMs = (int)std::chrono::duration_cast<std::chrono::milliseconds>(nextPoll - now).count();
+        if (clock.running) waitMs = std::min(waitMs, clock.msLeft());
+        wtimeout(win, std::max(0, waitMs));
+        int ch = wgetch(win);
+
+        if (ch == KEY_F(10)) break;
+        if (ch == KEY_RESIZE) {
+            wresize(win, LINES - 1, COLS);
+            wresize(bar, 1, COLS);
+            mvwin(bar, LINES - 1, 0);
+            clearok(curscr, TRUE);
+        } else if (ch != ERR) {
+            if (!api->handleKey(ch)) break;
+            clock.sync(api);
+        }
+
+        if (clock.due()) {
+            if (api->tick) api->tick();
+            clock.advance(api);
+        }
+        now = std::chrono::steady_clock::now();
+        if (now < nextPoll) continue;
+        nextPoll = now + std::chrono::milliseconds(PLUGIN_POLL_MS);
+
+        long long mtime = fileMtime(path);
+        if (mtime == 0 || mtime == plugin->mtime) { pendingMtime = 0; continue; }
+        if (mtime != pendingMtime) { pendingMtime = mtime; continue; }
+
+        api->teardown();
+        unloadPlugin(filename);
+        plugin = loadPlugin(filename);
+        if (!plugin || !plugin->api) {
+            reloadError = plugin ? "no game_plugin()" : pluginError;
+            api = nullptr;
+            break;
+        }
+        api = plugin->api;
+        api->init();
+        clock = TickClock();
+        clock.sync(api);
+        pendingMtime = 0;
+        barText = std::string(api->name) + "  |  [F10] Back to launcher  |  reloaded " + path;
+        clearok(curscr, TRUE);
+    }
+    if (api) api->teardown();
+
+    delwin(win);
+    delwin(bar);
+    initColors();
+    clearok(curscr, TRUE);
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    reportRun(g, PATH_PLUGIN, 0, 0, seconds, firstFrame);
+    if (!reloadError.empty()) {
+        statusMessage = "Reloading " + g->displayName + " failed: " + reloadError;
+        statusIsError = true;
+    }
+}
+
 void launchGame(Game* g) {
     auto it = std::find(recents.begin(), recents.end(), g->filename);
     if (it != recents.end()) recents.erase(it);
@@ -176,17 +1031,22 @@ void launchGame(Game* g) {
     if (recents.size() > 5) recents.pop_back();
     saveData();
 
-    def_prog_mode(); 
-    endwin();        
-
-    std::string cmd = EXEC_DIR + std::string("/") + g->filename;
-    system(cmd.c_str());
+    // Without a plugin for this game, zygote mode falls back to exec.
+    Plugin* plugin = loadPlugin(g->filename);
+    if (plugin && plugin->api) runInProcess(g, plugin);
+    else runChild(g, zygoteMode && plugin && (plugin->mainArgs || plugin->mainNoArgs) ? plugin : nullptr);
+}
 
-    reset_prog_mode();
-    refresh();
-    
-    scanGames();
+// Picks up a new snapshot from the watcher, keeping the selection on the
+// same game where it is still listed.
+bool refreshGames() {
+    std::string selected = visibleGames.empty() ? "" : visibleGames[selectedIdx]->filename;
+    if (!watcher->take(allGames)) return false;
+    buildSearchIndex();
     filterGames();
+    for (size_t i = 0; i < visibleGames.size(); i++)
+        if (visibleGames[i]->filename == selected) selectedIdx = i;
+    return true;
 }
 
 void printCentered(int y, std::string text, int attr = 0) {
@@ -211,7 +1071,7 @@ void drawBox(int y, int x, int h, int w) {
 }
 
 void drawUI() {
-    clear();
+    erase();
 
     attron(COLOR_PAIR(1) | A_BOLD);
     printCentered(2, "╔═╗╔═╗╔╗╔╔═╗╔═╗╦  ╔═╗  ╦  ╔═╗╦ ╦╔╗╔╔═╗╦ ╦╔═╗╦═╗");
@@ -263,7 +1123,7 @@ void drawUI() {
                     mvprintw(itemY, itemX - 2, ">");
                 }
                 
-                mvprintw(itemY, itemX, "%s", g->displayName.c_str());
+                printMatched(itemY, itemX, g->displayName);
                 
                 if (g->isFavorite) {
                     attron(COLOR_PAIR(4));
@@ -277,7 +1137,25 @@ void drawUI() {
             if (!visibleGames.empty()) {
                 int descY = LINES - 4;
                 attron(COLOR_PAIR(5));
-                printCentered(descY, visibleGames[selectedIdx]->description);
+                std::string desc = visibleGames[selectedIdx]->description;
+                if (!visibleGames[selectedIdx]->tags.empty()) {
+                    desc += " ";
+                    for (const auto& tag : splitWords(visibleGames[selectedIdx]->tags)) desc += " #" + tag;
+                }
+                auto last = lastRunSeconds.find(visibleGames[selectedIdx]->filename);
+                if (last != lastRunSeconds.end()) {
+                    char buf[48];
+                    snprintf(buf, sizeof(buf), "  (last run %.1f s)", last->second);
+                    desc += buf;
+                }
+                for (int via = PATH_EXEC; via < PATH_COUNT; via++) {
+                    auto ff = firstFrameMs[via].find(visibleGames[selectedIdx]->filename);
+                    if (ff == firstFrameMs[via].end()) continue;
+                    char buf[48];
+                    snprintf(buf, sizeof(buf), "  [%s: %.1f ms]", PATH_NAMES[via], ff->second);
+                    desc += buf;
+                }
+                printCentered(descY, desc);
                 attroff(COLOR_PAIR(5));
             }
 
@@ -313,7 +1191,7 @@ void drawUI() {
                 drawBox(bY, bX, boxH, boxW);
                 
                 int nameX = bX + (boxW - g->displayName.length()) / 2;
-                mvprintw(bY + 2, nameX, "%s", g->displayName.c_str());
+                printMatched(bY + 2, nameX, g->displayName);
 
                 if (g->isFavorite) {
                     attron(COLOR_PAIR(4));
@@ -327,10 +1205,22 @@ void drawUI() {
         }
     }
 
+    if (!statusMessage.empty()) {
+        attron(COLOR_PAIR(statusIsError ? 3 : 5));
+        printCentered(LINES - 3, statusMessage);
+        attroff(COLOR_PAIR(statusIsError ? 3 : 5));
+    }
+
     attron(COLOR_PAIR(5));
     mvhline(LINES - 2, 0, ACS_HLINE, COLS);
-    mvprintw(LINES - 1, 2, "[ENTER] Play | [F] Fav | [/] Search | [V] View | [TAB] Category | [Q] Quit");
+    mvprintw(LINES - 1, 2, "[ENTER] Play | [F] Fav | [/] Search | [V] View | [TAB] Category | [Z] Zygote | [Q] Quit");
     attroff(COLOR_PAIR(5));
+
+    if (zygoteMode) {
+        attron(COLOR_PAIR(4) | A_BOLD);
+        mvprintw(0, COLS - 9, "[ZYGOTE]");
+        attroff(COLOR_PAIR(4) | A_BOLD);
+    }
     
     refresh();
 }
@@ -338,8 +1228,11 @@ void drawUI() {
 int main() {
     setlocale(LC_ALL, ""); 
     loadData();
-    scanGames();
+    if (!fs::exists(EXEC_DIR)) fs::create_directory(EXEC_DIR);
+    allGames = loadManifest();
+    buildSearchIndex();
     filterGames();
+    watcher->start(allGames);
 
     initscr();
     cbreak();
@@ -347,18 +1240,17 @@ int main() {
     curs_set(0);
     keypad(stdscr, TRUE);
 
-    if (has_colors()) {
-        start_color();
-        init_pair(1, COLOR_CYAN, COLOR_BLACK);
-        init_pair(2, COLOR_GREEN, COLOR_BLACK);
-        init_pair(3, COLOR_RED, COLOR_BLACK);
-        init_pair(4, COLOR_YELLOW, COLOR_BLACK);
-        init_pair(5, COLOR_BLUE, COLOR_BLACK);
-    }
+    if (has_colors()) start_color();
+    initColors();
+    timeout(MANIFEST_POLL_MS);
 
+    bool redraw = true;
     while (true) {
-        drawUI();
+        if (refreshGames()) redraw = true;
+        if (redraw) drawUI();
+        redraw = true;
         int ch = getch();
+        if (ch == ERR) { redraw = false; continue; }
 
         if (searchMode) {
             if (ch == 10) {
@@ -383,6 +1275,7 @@ int main() {
         switch(ch) {
             case 'q': case 'Q':
                 saveData();
+                watcher->stop();
                 endwin();
                 return 0;
             
@@ -428,6 +1321,11 @@ int main() {
                 viewBlockMode = !viewBlockMode;
                 break;
 
+            case 'z': case 'Z':
+                zygoteMode = !zygoteMode;
+                if (zygoteMode) preloadPlugins();
+                break;
+
             case '/':
                 searchMode = true;
                 currentTab = 0; 
@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <cstring>
 #include <clocale>
+#include "game_plugin.h"
 
 const int GRID_SIZE = 4;
 const int CELL_WIDTH = 10;
@@ -158,31 +159,31 @@ int getColorPair(int value) {
     return 8;                    
 }
 
-void drawBox(int y, int x, int h, int w) {
-    mvprintw(y, x, "┌");
-    mvprintw(y, x + w - 1, "┐");
-    mvprintw(y + h - 1, x, "└");
-    mvprintw(y + h - 1, x + w - 1, "┘");
+void drawBox(WINDOW* win, int y, int x, int h, int w) {
+    mvwprintw(win, y, x, "┌");
+    mvwprintw(win, y, x + w - 1, "┐");
+    mvwprintw(win, y + h - 1, x, "└");
+    mvwprintw(win, y + h - 1, x + w - 1, "┘");
     for (int i = 1; i < w - 1; i++) {
-        mvprintw(y, x + i, "─");
-        mvprintw(y + h - 1, x + i, "─");
+        mvwprintw(win, y, x + i, "─");
+        mvwprintw(win, y + h - 1, x + i, "─");
     }
     for (int i = 1; i < h - 1; i++) {
-        mvprintw(y + i, x, "│");
-        mvprintw(y + i, x + w - 1, "│");
+        mvwprintw(win, y + i, x, "│");
+        mvwprintw(win, y + i, x + w - 1, "│");
     }
 }
 
-void draw() {
-    clear();
+void draw(WINDOW* win) {
+    werase(win);
     int boardWidth = GRID_SIZE * CELL_WIDTH;
     int boardHeight = GRID_SIZE * CELL_HEIGHT;
-    int startY = (LINES - boardHeight) / 2;
-    int startX = (COLS - boardWidth) / 2;
+    int startY = (getmaxy(win) - boardHeight) / 2;
+    int startX = (getmaxx(win) - boardWidth) / 2;
 
-    mvprintw(startY - 4, startX, "SCORE: %d", score);
-    mvprintw(startY - 4, startX + boardWidth - 15, "HIGH: %d", highScore);
-    mvprintw(startY - 2, startX, "Use WASD or Arrows to slide.");
+    mvwprintw(win, startY - 4, startX, "SCORE: %d", score);
+    mvwprintw(win, startY - 4, startX + boardWidth - 15, "HIGH: %d", highScore);
+    mvwprintw(win, startY - 2, startX, "Use WASD or Arrows to slide.");
 
     for (int i = 0; i < GRID_SIZE; i++) {
         for (int j = 0; j < GRID_SIZE; j++) {
@@ -191,83 +192,66 @@ void draw() {
             int val = board[i][j];
 
             int color = getColorPair(val);
-            attron(COLOR_PAIR(color));
+            wattron(win, COLOR_PAIR(color));
             
-            drawBox(y, x, CELL_HEIGHT, CELL_WIDTH);
+            drawBox(win, y, x, CELL_HEIGHT, CELL_WIDTH);
 
             if (val != 0) {
                 std::string s = std::to_string(val);
                 int textX = x + (CELL_WIDTH - s.length()) / 2;
                 int textY = y + CELL_HEIGHT / 2;
-                mvprintw(textY, textX, "%s", s.c_str());
+                mvwprintw(win, textY, textX, "%s", s.c_str());
             }
-            attroff(COLOR_PAIR(color));
+            wattroff(win, COLOR_PAIR(color));
         }
     }
-
-    refresh();
 }
 
-void printCentered(int y, std::string text, bool highlight = false) {
-    int midX = COLS / 2;
+void printCentered(WINDOW* win, int y, std::string text, bool highlight = false) {
+    int midX = getmaxx(win) / 2;
     int startX = midX - (text.length() / 2);
-    if (highlight) attron(A_REVERSE);
-    mvprintw(y, startX, "%s", text.c_str());
-    if (highlight) attroff(A_REVERSE);
+    if (highlight) wattron(win, A_REVERSE);
+    mvwprintw(win, y, startX, "%s", text.c_str());
+    if (highlight) wattroff(win, A_REVERSE);
 }
 
-void showMenu() {
-    int selected = 0;
+// The game runs as a small state machine driven by the plugin host: the
+// menu, a game in progress, and the end screen waiting for ENTER.
+enum Screen { SCREEN_MENU, SCREEN_PLAYING, SCREEN_OVER };
+Screen screen = SCREEN_MENU;
+int menuSelected = 0;
+
+void drawMenu(WINDOW* win) {
     const char* options[2] = {"Start Game", "Exit"};
-    
-    while (true) {
-        clear();
-        int midY = LINES / 2;
-        int midX = COLS / 2;
-
-        int w = 32, h = 12;
-        int boxY = midY - h/2;
-        int boxX = midX - w/2;
-        
-        attron(COLOR_PAIR(6)); 
-        drawBox(boxY, boxX, h, w);
-        attroff(COLOR_PAIR(6));
+    werase(win);
+    int midY = getmaxy(win) / 2;
+    int midX = getmaxx(win) / 2;
 
-        printCentered(midY - 3, "=== 2048 ===");
-        
-        char scoreBuf[40];
-        snprintf(scoreBuf, sizeof(scoreBuf), "High Score: %d", highScore);
-        printCentered(midY - 1, scoreBuf);
+    int w = 32, h = 12;
+    int boxY = midY - h/2;
+    int boxX = midX - w/2;
+    
+    wattron(win, COLOR_PAIR(6)); 
+    drawBox(win, boxY, boxX, h, w);
+    wattroff(win, COLOR_PAIR(6));
 
-        for (int i = 0; i < 2; i++) {
-            printCentered(midY + 2 + i * 2, options[i], (i == selected));
-        }
+    printCentered(win, midY - 3, "=== 2048 ===");
+    
+    char scoreBuf[40];
+    snprintf(scoreBuf, sizeof(scoreBuf), "High Score: %d", highScore);
+    printCentered(win, midY - 1, scoreBuf);
 
-        int c = getch();
-        switch (c) {
-            case KEY_UP: case 'w': if (selected > 0) selected--; break;
-            case KEY_DOWN: case 's': if (selected < 1) selected++; break;
-            case 10: 
-                if (selected == 0) return; 
-                if (selected == 1) { endwin(); exit(0); }
-                break;
-        }
+    for (int i = 0; i < 2; i++) {
+        printCentered(win, midY + 2 + i * 2, options[i], (i == menuSelected));
     }
 }
 
-int main() {
-    setlocale(LC_ALL, "");
+void init() {
     srand(time(0));
     loadHighScore();
-
-    initscr();
-    cbreak();
-    noecho();
-    curs_set(0);
-    keypad(stdscr, TRUE);
+    screen = SCREEN_MENU;
 
     if (has_colors()) {
-        start_color();
         init_pair(1, COLOR_WHITE, COLOR_BLACK);   
         init_pair(2, COLOR_WHITE, COLOR_BLACK);   
         init_pair(3, COLOR_CYAN, COLOR_BLACK);    
@@ -277,41 +261,65 @@ int main() {
         init_pair(7, COLOR_RED, COLOR_BLACK);     
         init_pair(8, COLOR_BLUE, COLOR_BLACK);    
     }
+}
 
-    while (true) {
-        nodelay(stdscr, FALSE);
-        showMenu();
-
-        initGame();
-        nodelay(stdscr, FALSE);
-
-        while (!gameOver && !victory) {
-            draw();
-            int ch = getch();
-            switch(ch) {
-                case KEY_LEFT:  case 'a': move(0); break;
-                case KEY_RIGHT: case 'd': move(1); break;
-                case KEY_UP:    case 'w': move(2); break;
-                case KEY_DOWN:  case 's': move(3); break;
-                case 'q': gameOver = true; break;
-            }
+bool handleKey(int ch) {
+    if (screen == SCREEN_MENU) {
+        switch (ch) {
+            case KEY_UP: case 'w': if (menuSelected > 0) menuSelected--; break;
+            case KEY_DOWN: case 's': if (menuSelected < 1) menuSelected++; break;
+            case 10: 
+                if (menuSelected == 1) return false;
+                initGame();
+                screen = SCREEN_PLAYING;
+                break;
+        }
+    } else if (screen == SCREEN_PLAYING) {
+        switch(ch) {
+            case KEY_LEFT:  case 'a': move(0); break;
+            case KEY_RIGHT: case 'd': move(1); break;
+            case KEY_UP:    case 'w': move(2); break;
+            case KEY_DOWN:  case 's': move(3); break;
+            case 'q': gameOver = true; break;
+        }
+        if (gameOver || victory) {
+            saveHighScore();
+            screen = SCREEN_OVER;
         }
+    } else if (ch == 10) {
+        screen = SCREEN_MENU;
+    }
+    return true;
+}
 
-        draw(); 
-        saveHighScore();
-        
-        attron(COLOR_PAIR(7)); 
-        int midY = LINES / 2;
-        if (victory) printCentered(midY, "YOU WIN! (2048 Reached)");
-        else printCentered(midY, "GAME OVER!");
+void render(WINDOW* win) {
+    if (screen == SCREEN_MENU) {
+        drawMenu(win);
+        return;
+    }
+    draw(win);
+    if (screen == SCREEN_OVER) {
+        wattron(win, COLOR_PAIR(7)); 
+        int midY = getmaxy(win) / 2;
+        if (victory) printCentered(win, midY, "YOU WIN! (2048 Reached)");
+        else printCentered(win, midY, "GAME OVER!");
         
-        printCentered(midY + 1, "Press ENTER to continue");
-        attroff(COLOR_PAIR(7));
-        refresh();
-
-        while (getch() != 10);
+        printCentered(win, midY + 1, "Press ENTER to continue");
+        wattroff(win, COLOR_PAIR(7));
     }
+}
+
+void teardown() {
+    if (screen != SCREEN_MENU) saveHighScore();
+}
 
-    endwin();
-    return 0;
+const GamePlugin plugin = {
+    GAME_PLUGIN_ABI_VERSION, "2048", 0, init, handleKey, nullptr, render, teardown, nullptr,
+};
+
+extern "C" const GamePlugin* game_plugin() { return &plugin; }
+
+int main() {
+    setlocale(LC_ALL, "");
+    return runGamePlugin(&plugin);
 }
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <ncurses.h>
+#include <algorithm>
+#include <chrono>
+
+// In-process game interface. A game built as exec/plugins/<name>.so exports
+// game_plugin(); the launcher dlopens it and drives the game from its own
+// event loop, so switching games costs no process and no terminal setup.
+// The same table drives the standalone binary through runGamePlugin().
+//
+// The host owns the terminal: a plugin never calls initscr(), endwin() or
+// exit(), and draws only into the window it is handed.
+
+#define GAME_PLUGIN_ABI_VERSION 2
+
+struct GamePlugin {
+    int abiVersion;
+    const char* name;
+    // Milliseconds between tick() calls; 0 if the game only reacts to keys.
+    int tickMs;
+    // Called each time the game is entered (colors, high scores).
+    void (*init)();
+    // False hands control back to the host, as the game's own "Exit" does.
+    bool (*handleKey)(int ch);
+    void (*tick)();
+    void (*render)(WINDOW* win);
+    // Called when the game is left or about to be unloaded.
+    void (*teardown)();
+    // Games whose pace changes as they play (speed settings, menus that do
+    // not tick) set this instead of tickMs: milliseconds from one tick to
+    // the next as the game stands now, 0 while it needs no ticks. Asked
+    // after init() and after every key and tick.
+    int (*tickInterval)();
+};
+
+extern "C" const GamePlugin* game_plugin();
+
+// When the game's next tick is due, for both hosts. Ticks keep a fixed
+// cadence: each is due one interval after the previous one was due, not
+// after it ran, so a slow frame does not slow the game down. A game that
+// starts ticking again (a new round out of its menu) starts from now.
+struct TickClock {
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point next;
+    bool running = false;
+
+    static int interval(const GamePlugin* game) {
+        return game->tickInterval ? game->tickInterval() : game->tickMs;
+    }
+
+    // After init() and every key: picks up a game that starts or stops
+    // ticking.
+    void sync(const GamePlugin* game) {
+        int ms = interval(game);
+        if (ms > 0 && !running) next = Clock::now() + std::chrono::milliseconds(ms);
+        running = ms > 0;
+    }
+
+    bool due() const { return running && Clock::now() >= next; }
+
+    // After a tick: schedules the next one.
+    void advance(const GamePlugin* game) {
+        int ms = interval(game);
+        running = ms > 0;
+        if (running) next = std::max(next + std::chrono::milliseconds(ms), Clock::now());
+    }
+
+    // For wtimeout(): -1 when no tick is pending.
+    int msLeft() const {
+        if (!running) return -1;
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(next - Clock::now()).count();
+        return std::max(0, (int)left);
+    }
+};
+
+// Standalone host: the loop the launcher runs, on stdscr.
+inline int runGamePlugin(const GamePlugin* game) {
+    initscr();
+    cbreak();
+    noecho();
+    curs_set(0);
+    keypad(stdscr, TRUE);
+    if (has_colors()) start_color();
+
+    game->init();
+    TickClock clock;
+    clock.sync(game);
+    while (true) {
+        game->render(stdscr);
+        wrefresh(stdscr);
+        wtimeout(stdscr, clock.msLeft());
+        int ch = wgetch(stdscr);
+        if (ch != ERR) {
+            if (!game->handleKey(ch)) break;
+            clock.sync(game);
+        }
+        if (clock.due()) {
+            if (game->tick) game->tick();
+            clock.advance(game);
+        }
+    }
+    game->teardown();
+
+    endwin();
+    return 0;
+}
@@ -6,6 +6,7 @@
 #include <string>
 #include <algorithm>
 #include <cstring>
+#include "game_plugin.h"
 
 struct Cell {
     bool isMine = false;
@@ -29,37 +30,37 @@ int cursorX = 0, cursorY = 0;
 bool gameOver = false;
 bool victory = false;
 
-void drawBox(int y, int x, int h, int w, const char* title = nullptr) {
-    attron(COLOR_PAIR(1));
-    mvprintw(y, x, "┌");
-    mvprintw(y, x + w - 1, "┐");
-    mvprintw(y + h - 1, x, "└");
-    mvprintw(y + h - 1, x + w - 1, "┘");
+void drawBox(WINDOW* win, int y, int x, int h, int w, const char* title = nullptr) {
+    wattron(win, COLOR_PAIR(1));
+    mvwprintw(win, y, x, "┌");
+    mvwprintw(win, y, x + w - 1, "┐");
+    mvwprintw(win, y + h - 1, x, "└");
+    mvwprintw(win, y + h - 1, x + w - 1, "┘");
     for (int i = 1; i < w - 1; i++) {
-        mvprintw(y, x + i, "─");
-        mvprintw(y + h - 1, x + i, "─");
+        mvwprintw(win, y, x + i, "─");
+        mvwprintw(win, y + h - 1, x + i, "─");
     }
     for (int i = 1; i < h - 1; i++) {
-        mvprintw(y + i, x, "│");
-        mvprintw(y + i, x + w - 1, "│");
+        mvwprintw(win, y + i, x, "│");
+        mvwprintw(win, y + i, x + w - 1, "│");
     }
 
     if (title) {
         int titleLen = strlen(title);
         int titleX = x + (w - titleLen) / 2;
-        mvprintw(y, titleX - 1, " ");
-        mvprintw(y, titleX, "%s", title);
-        mvprintw(y, titleX + titleLen, " ");
+        mvwprintw(win, y, titleX - 1, " ");
+        mvwprintw(win, y, titleX, "%s", title);
+        mvwprintw(win, y, titleX + titleLen, " ");
     }
-    attroff(COLOR_PAIR(1));
+    wattroff(win, COLOR_PAIR(1));
 }
 
-void printCentered(int y, std::string text, int attrs = 0) {
-    int midX = COLS / 2;
+void printCentered(WINDOW* win, int y, std::string text, int attrs = 0) {
+    int midX = getmaxx(win) / 2;
     int startX = midX - (text.length() / 2);
-    if (attrs) attron(attrs);
-    mvprintw(y, startX, "%s", text.c_str());
-    if (attrs) attroff(attrs);
+    if (attrs) wattron(win, attrs);
+    mvwprintw(win, y, startX, "%s", text.c_str());
+    if (attrs) wattroff(win, attrs);
 }
 
 bool isValid(int y, int x) {
@@ -190,84 +191,56 @@ void changeSetting(int index, int delta) {
     }
 }
 
-void showSettings() {
-    while (true) {
-        clear();
-        int midY = LINES / 2;
-        int midX = COLS / 2;
-        int boxW = 30, boxH = 12;
-
-        drawBox(midY - boxH/2, midX - boxW/2, boxH, boxW, "SETTINGS");
-
-        for (int i = 0; i < 4; i++) {
-            std::string label = getSettingLabel(i);
-            int y = midY - 2 + i * 2;
-            int attr = (i == config.settingsIndex) ? A_REVERSE : 0;
-            printCentered(y, label, attr);
-        }
-
-        mvprintw(midY + boxH/2 + 1, midX - 12, "Left/Right to change");
-
-        int ch = getch();
-        switch(ch) {
-            case KEY_UP: case 'w': 
-                if (config.settingsIndex > 0) config.settingsIndex--; 
-                break;
-            case KEY_DOWN: case 's': 
-                if (config.settingsIndex < 3) config.settingsIndex++; 
-                break;
-            case KEY_LEFT: case 'a': 
-                if (config.settingsIndex < 3) changeSetting(config.settingsIndex, -1); 
-                break;
-            case KEY_RIGHT: case 'd': 
-                if (config.settingsIndex < 3) changeSetting(config.settingsIndex, 1); 
-                break;
-            case 10:
-                if (config.settingsIndex == 3) return;
-                break;
-        }
+// The game runs as a small state machine driven by the plugin host: the
+// menu, its settings page, a game in progress, and the end screen waiting
+// for ENTER.
+enum Screen { SCREEN_MENU, SCREEN_SETTINGS, SCREEN_PLAYING, SCREEN_OVER };
+Screen screen = SCREEN_MENU;
+
+void drawSettings(WINDOW* win) {
+    werase(win);
+    int midY = getmaxy(win) / 2;
+    int midX = getmaxx(win) / 2;
+    int boxW = 30, boxH = 12;
+
+    drawBox(win, midY - boxH/2, midX - boxW/2, boxH, boxW, "SETTINGS");
+
+    for (int i = 0; i < 4; i++) {
+        std::string label = getSettingLabel(i);
+        int y = midY - 2 + i * 2;
+        int attr = (i == config.settingsIndex) ? A_REVERSE : 0;
+        printCentered(win, y, label, attr);
     }
+
+    mvwprintw(win, midY + boxH/2 + 1, midX - 12, "Left/Right to change");
 }
 
-void showMenu() {
+void drawMenu(WINDOW* win) {
     const char* options[3] = {"Start Game", "Settings", "Exit"};
 
-    while (true) {
-        clear();
-        int midY = LINES / 2;
-        int midX = COLS / 2;
-        int boxW = 30, boxH = 12;
-
-        drawBox(midY - boxH/2, midX - boxW/2, boxH, boxW);
-        printCentered(midY - 4, "=== MINESWEEPER ===");
+    werase(win);
+    int midY = getmaxy(win) / 2;
+    int midX = getmaxx(win) / 2;
+    int boxW = 30, boxH = 12;
 
-        for (int i = 0; i < 3; i++) {
-            int attr = (i == config.menuIndex) ? A_REVERSE : 0;
-            printCentered(midY - 1 + i * 2, options[i], attr);
-        }
+    drawBox(win, midY - boxH/2, midX - boxW/2, boxH, boxW);
+    printCentered(win, midY - 4, "=== MINESWEEPER ===");
 
-        int ch = getch();
-        switch(ch) {
-            case KEY_UP: case 'w': if (config.menuIndex > 0) config.menuIndex--; break;
-            case KEY_DOWN: case 's': if (config.menuIndex < 2) config.menuIndex++; break;
-            case 10: 
-                if (config.menuIndex == 0) return;
-                if (config.menuIndex == 1) showSettings();
-                if (config.menuIndex == 2) { endwin(); exit(0); }
-                break;
-        }
+    for (int i = 0; i < 3; i++) {
+        int attr = (i == config.menuIndex) ? A_REVERSE : 0;
+        printCentered(win, midY - 1 + i * 2, options[i], attr);
     }
 }
 
-void draw() {
-    clear();
-    int startY = (LINES - config.height) / 2;
-    int startX = (COLS - config.width * 2) / 2;
+void draw(WINDOW* win) {
+    werase(win);
+    int startY = (getmaxy(win) - config.height) / 2;
+    int startX = (getmaxx(win) - config.width * 2) / 2;
 
-    drawBox(startY - 1, startX - 1, config.height + 2, config.width * 2 + 2);
+    drawBox(win, startY - 1, startX - 1, config.height + 2, config.width * 2 + 2);
 
-    mvprintw(startY - 2, startX, "Mines: %d", config.mines);
-    mvprintw(startY + config.height + 1, startX, "[SPACE] Open  [F] Flag  [Q] Quit");
+    mvwprintw(win, startY - 2, startX, "Mines: %d", config.mines);
+    mvwprintw(win, startY + config.height + 1, startX, "[SPACE] Open  [F] Flag  [Q] Quit");
 
     for (int y = 0; y < config.height; y++) {
         for (int x = 0; x < config.width; x++) {
@@ -275,82 +248,86 @@ void draw() {
             int drawX = startX + x * 2;
             bool isCursor = (y == cursorY && x == cursorX);
 
-            if (isCursor) attron(A_REVERSE);
+            if (isCursor) wattron(win, A_REVERSE);
 
             if (board[y][x].isFlagged) {
-                attron(COLOR_PAIR(4)); 
-                mvprintw(drawY, drawX, " F");
-                attroff(COLOR_PAIR(4));
+                wattron(win, COLOR_PAIR(4)); 
+                mvwprintw(win, drawY, drawX, " F");
+                wattroff(win, COLOR_PAIR(4));
             } 
             else if (!board[y][x].isOpen) {
-                mvprintw(drawY, drawX, " .");
+                mvwprintw(win, drawY, drawX, " .");
             } 
             else {
                 if (board[y][x].isMine) {
-                    attron(COLOR_PAIR(5) | A_BOLD); 
-                    mvprintw(drawY, drawX, " X");
-                    attroff(COLOR_PAIR(5) | A_BOLD);
+                    wattron(win, COLOR_PAIR(5) | A_BOLD); 
+                    mvwprintw(win, drawY, drawX, " X");
+                    wattroff(win, COLOR_PAIR(5) | A_BOLD);
                 } 
                 else if (board[y][x].neighbors > 0) {
                     int color = (board[y][x].neighbors == 1) ? 2 : (board[y][x].neighbors == 2) ? 3 : 4;
-                    attron(COLOR_PAIR(color));
-                    mvprintw(drawY, drawX, " %d", board[y][x].neighbors);
-                    attroff(COLOR_PAIR(color));
+                    wattron(win, COLOR_PAIR(color));
+                    mvwprintw(win, drawY, drawX, " %d", board[y][x].neighbors);
+                    wattroff(win, COLOR_PAIR(color));
                 } 
                 else {
-                    mvprintw(drawY, drawX, "  ");
+                    mvwprintw(win, drawY, drawX, "  ");
                 }
             }
 
-            if (isCursor) attroff(A_REVERSE);
+            if (isCursor) wattroff(win, A_REVERSE);
         }
     }
-    refresh();
 }
 
-int main() {
-    setlocale(LC_ALL, ""); 
+void init() {
     srand(time(0));
-
-    initscr();
-    cbreak();
-    noecho();
-    curs_set(0); 
-    keypad(stdscr, TRUE); 
+    screen = SCREEN_MENU;
 
     if (has_colors()) {
-        start_color();
         init_pair(1, COLOR_WHITE, COLOR_BLACK);
         init_pair(2, COLOR_BLUE, COLOR_BLACK);
         init_pair(3, COLOR_GREEN, COLOR_BLACK);
         init_pair(4, COLOR_RED, COLOR_BLACK);
         init_pair(5, COLOR_MAGENTA, COLOR_BLACK);
     }
+}
 
-    while (true) {
-        showMenu();
-        initGame();
-
-        while (true) {
-            draw();
-
-            if (gameOver || victory) {
-                int midY = LINES / 2;
-
-                attron(COLOR_PAIR(1) | A_BOLD);
-
-                if (victory) printCentered(midY, " VICTORY! ", A_REVERSE | A_BOLD);
-                else printCentered(midY, " GAME OVER ", A_REVERSE | A_BOLD);
-
-                printCentered(midY + 1, " Press ENTER to menu ");
-                attroff(COLOR_PAIR(1) | A_BOLD);
+bool handleKey(int ch) {
+    switch (screen) {
+        case SCREEN_MENU:
+            switch(ch) {
+                case KEY_UP: case 'w': if (config.menuIndex > 0) config.menuIndex--; break;
+                case KEY_DOWN: case 's': if (config.menuIndex < 2) config.menuIndex++; break;
+                case 10: 
+                    if (config.menuIndex == 0) { initGame(); screen = SCREEN_PLAYING; }
+                    if (config.menuIndex == 1) screen = SCREEN_SETTINGS;
+                    if (config.menuIndex == 2) return false;
+                    break;
+            }
+            break;
 
-                refresh();
-                while (getch() != 10);
-                break;
+        case SCREEN_SETTINGS:
+            switch(ch) {
+                case KEY_UP: case 'w': 
+                    if (config.settingsIndex > 0) config.settingsIndex--; 
+                    break;
+                case KEY_DOWN: case 's': 
+                    if (config.settingsIndex < 3) config.settingsIndex++; 
+                    break;
+                case KEY_LEFT: case 'a': 
+                    if (config.settingsIndex < 3) changeSetting(config.settingsIndex, -1); 
+                    break;
+                case KEY_RIGHT: case 'd': 
+                    if (config.settingsIndex < 3) changeSetting(config.settingsIndex, 1); 
+                    break;
+                case 10:
+                    if (config.settingsIndex == 3) screen = SCREEN_MENU;
+                    break;
             }
+            break;
 
-            int ch = getch();
+        case SCREEN_PLAYING:
             switch (ch) {
                 case KEY_LEFT:  case 'a': if (cursorX > 0) cursorX--; break;
                 case KEY_RIGHT: case 'd': if (cursorX < config.width - 1) cursorX++; break;
@@ -360,9 +337,43 @@ int main() {
                 case 'f':       actionFlag(); break; 
                 case 'q':       gameOver = true; break;
             }
-        }
+            if (gameOver || victory) screen = SCREEN_OVER;
+            break;
+
+        case SCREEN_OVER:
+            if (ch == 10) screen = SCREEN_MENU;
+            break;
+    }
+    return true;
+}
+
+void render(WINDOW* win) {
+    if (screen == SCREEN_MENU) { drawMenu(win); return; }
+    if (screen == SCREEN_SETTINGS) { drawSettings(win); return; }
+
+    draw(win);
+    if (screen == SCREEN_OVER) {
+        int midY = getmaxy(win) / 2;
+
+        wattron(win, COLOR_PAIR(1) | A_BOLD);
+
+        if (victory) printCentered(win, midY, " VICTORY! ", A_REVERSE | A_BOLD);
+        else printCentered(win, midY, " GAME OVER ", A_REVERSE | A_BOLD);
+
+        printCentered(win, midY + 1, " Press ENTER to menu ");
+        wattroff(win, COLOR_PAIR(1) | A_BOLD);
     }
+}
+
+void teardown() {}
+
+const GamePlugin plugin = {
+    GAME_PLUGIN_ABI_VERSION, "minesweeper", 0, init, handleKey, nullptr, render, teardown, nullptr,
+};
+
+extern "C" const GamePlugin* game_plugin() { return &plugin; }
 
-    endwin();
-    return 0;
-}
\ No newline at end of file
+int main() {
+    setlocale(LC_ALL, ""); 
+    return runGamePlugin(&plugin);
+}
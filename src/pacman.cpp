@@ -1,25 +1,24 @@
+#include <ncurses.h>
 #include <iostream>
 #include <vector>
 #include <string>
-#include <unistd.h>
-#include <termios.h>
-#include <sys/ioctl.h>
+#include <clocale>
 #include <cstdlib>
+#include <cstring>
+#include <cstdint>
 #include <ctime>
+#include <random>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include "game_plugin.h"
+#include "worker_pool.h"
 
 using namespace std;
 
-#define RESET       "\033[0m"
-#define YELLOW      "\033[1;33m"
-#define BLUE        "\033[1;34m"
-#define RED         "\033[1;31m"
-#define CYAN        "\033[1;36m"
-#define GREEN       "\033[1;32m"
-#define WHITE       "\033[1;37m"
-#define GRAY        "\033[1;30m"
-#define BG_WHITE    "\033[47m"
-#define BG_BLACK    "\033[40m"
-#define BLACK_TXT   "\033[30m"
+// Color pairs, drawn bold as the game always was. The selected button is
+// black on white.
+enum Pair { PAIR_YELLOW = 1, PAIR_BLUE, PAIR_RED, PAIR_CYAN, PAIR_GREEN, PAIR_WHITE, PAIR_GRAY, PAIR_SELECTED };
 
 const string WALL_CHAR      = "██";
 const string EMPTY_CHAR     = "  ";
@@ -28,221 +27,146 @@ const string POWER_CHAR     = " ●";
 const string GHOST_CHAR     = " &";
 const int POWER_DURATION    = 50;
 
-struct termios orig_termios;
+struct Point { int x, y; };
 
-void restoreTerminal() {
-    tcsetattr(STDIN_FILENO, TCSAFLUSH, &orig_termios);
-    cout << "\033[?25h";
-    cout << "\033[?1049l";
-}
+struct MapTemplate {
+    int w, h;
+    vector<char> tiles;
+    vector<Point> spawnPoints;
+    Point playerSpawn;
+    Point ghostSpawn;
+    int dots, powers;
 
-void setupTerminal() {
-    tcgetattr(STDIN_FILENO, &orig_termios);
-    atexit(restoreTerminal);
+    MapTemplate(const vector<string>& layout) {
+        h = layout.size();
+        w = layout[0].size();
+        tiles.assign(w * h, ' ');
+        dots = 0;
+        powers = 0;
+        playerSpawn = {0, 0};
+        ghostSpawn = {0, 0};
 
-    struct termios raw = orig_termios;
-    raw.c_lflag &= ~(ECHO | ICANON | ISIG);
-    raw.c_cc[VMIN] = 0;
-    raw.c_cc[VTIME] = 0;
-    tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw);
+        for(int y=0; y<h; y++) {
+            for(int x=0; x<w; x++) {
+                char c = layout[y][x];
+                if(c == 'P') {
+                    playerSpawn = {x, y};
+                    c = ' ';
+                } else if(c == 'G') {
+                    ghostSpawn = {x, y};
+                    spawnPoints.push_back({x, y});
+                    c = ' ';
+                } else if(c == '.') {
+                    dots++;
+                } else if(c == '*') {
+                    powers++;
+                }
+                tiles[y * w + x] = c;
+            }
+        }
+    }
+};
 
-    cout << "\033[?1049h";
-    cout << "\033[?25l";
+const MapTemplate& classicMap() {
+    static const MapTemplate tpl({
+        "###################",
+        "#........#........#",
+        "#.##.###.#.###.##.#",
+        "#*................*",
+        "#.##.#.#####.#.##.#",
+        "#....#...#...#....#",
+        "####.### # ###.####",
+        "    .#   G   #.    ",
+        "####.### # ###.####",
+        "#........P........#",
+        "#.##.###.#.###.##.#",
+        "#*................*",
+        "##.#.#.#####.#.#.##",
+        "#....#...#...#....#",
+        "#.######.#.######.#",
+        "#.................#",
+        "###################"
+    });
+    return tpl;
 }
 
-struct Point { int x, y; };
+enum Action : uint8_t { ACT_NONE, ACT_UP, ACT_DOWN, ACT_LEFT, ACT_RIGHT, ACTION_COUNT };
+const Point ACTION_DIRS[ACTION_COUNT] = { {0, 0}, {0, -1}, {0, 1}, {-1, 0}, {1, 0} };
 
-class PacmanGame {
-    enum State { MENU, SETTINGS, GAME, GAME_OVER };
-    State currentState;
-    
-    int menuSelection;
-    int settingsSelection;
-
-    vector<string> map;
-    vector<string> initialMap;
-    int w, h;
-    int score;
-    bool win;
-
-    int setSpeedIndex; 
-    int setGhostCount;
-    int gameSpeedDelay;
+enum ObsBits : uint8_t {
+    OBS_EMPTY = 0, OBS_WALL = 1, OBS_DOT = 2, OBS_POWER = 3,
+    OBS_PLAYER = 1 << 2, OBS_GHOST = 1 << 3, OBS_FRIGHTENED = 1 << 4
+};
 
-    Point player;
-    Point dir;
-    Point nextDir;
-    Point ghostSpawn;
-    
+// Pure simulation state: no terminal, no global RNG. Everything the UI and the
+// batched environment need to advance one tick lives here.
+struct PacmanSim {
     struct Ghost {
         Point pos;
         Point dir;
         bool isDead;
     };
+
+    const MapTemplate* tpl;
+    vector<char> tiles;
+    int w, h;
+    int dotsLeft, powerLeft;
+    int ghostCount;
+
+    Point player;
+    Point dir;
+    Point nextDir;
     vector<Ghost> ghosts;
 
     bool isPowered;
     int powerTimer;
+    int score;
+    bool over;
+    bool win;
+    minstd_rand rng;
 
-    int padTop, padLeft;
-
-public:
-    PacmanGame() {
-        initialMap = {
-            "###################",
-            "#........#........#",
-            "#.##.###.#.###.##.#",
-            "#*................*",
-            "#.##.#.#####.#.##.#",
-            "#....#...#...#....#",
-            "####.### # ###.####",
-            "    .#   G   #.    ",
-            "####.### # ###.####",
-            "#........P........#",
-            "#.##.###.#.###.##.#",
-            "#*................*",
-            "##.#.#.#####.#.#.##",
-            "#....#...#...#....#",
-            "#.######.#.######.#",
-            "#.................#",
-            "###################"
-        };
-
-        h = initialMap.size();
-        w = initialMap[0].size();
-        
-        currentState = MENU;
-        menuSelection = 0;
-        settingsSelection = 0;
-        
-        setSpeedIndex = 1; 
-        setGhostCount = 4;
-        
-        resetGame();
+    PacmanSim(const MapTemplate& t = classicMap(), int ghostCount = 4)
+        : tpl(&t), tiles(t.w * t.h), w(t.w), h(t.h), ghostCount(ghostCount) {
+        reset(1);
     }
 
-    void resetGame() {
-        map = initialMap;
+    void reset(uint32_t seed) {
+        rng.seed(seed);
+        memcpy(tiles.data(), tpl->tiles.data(), w * h);
+        dotsLeft = tpl->dots;
+        powerLeft = tpl->powers;
+        player = tpl->playerSpawn;
         score = 0;
+        over = false;
         win = false;
         dir = {0, 0};
         nextDir = {0, 0};
         isPowered = false;
         powerTimer = 0;
-        
-        ghosts.clear();
 
-        vector<Point> spawnPoints;
-
-        for(int y=0; y<h; y++) {
-            for(int x=0; x<w; x++) {
-                if(map[y][x] == 'P') {
-                    player = {x, y};
-                    map[y][x] = ' ';
-                } else if(map[y][x] == 'G') {
-                    ghostSpawn = {x, y};
-                    spawnPoints.push_back({x, y});
-                    map[y][x] = ' ';
-                }
-            }
-        }
-
-        for(int i=0; i<setGhostCount; i++) {
+        ghosts.clear();
+        for(int i=0; i<ghostCount; i++) {
             // ВИПРАВЛЕНО WARNING: додано (size_t)
-            Point p = ((size_t)i < spawnPoints.size()) ? spawnPoints[i] : ghostSpawn;
+            Point p = ((size_t)i < tpl->spawnPoints.size()) ? tpl->spawnPoints[i] : tpl->ghostSpawn;
             ghosts.push_back({p, {0, 0}, false});
         }
-
-        int speeds[] = { 130000, 90000, 60000, 30000 };
-        gameSpeedDelay = speeds[setSpeedIndex];
     }
 
-    void calculateLayout() {
-        struct winsize ws;
-        ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws);
-        
-        int gameWidth = (w * 2) + 4;
-        int gameHeight = h + 6;
+    char& tile(int x, int y) { return tiles[y * w + x]; }
+    char tile(int x, int y) const { return tiles[y * w + x]; }
 
-        padTop = (ws.ws_row - gameHeight) / 2;
-        padLeft = (ws.ws_col - gameWidth) / 2;
-        if(padTop < 0) padTop = 0;
-        if(padLeft < 0) padLeft = 0;
+    bool isWall(int x, int y) const {
+        if(x < 0 || x >= w || y < 0 || y >= h) return true;
+        return tile(x, y) == '#';
     }
 
-    void handleInput() {
-        char buf[3];
-        int n = read(STDIN_FILENO, buf, sizeof(buf));
-
-        if (n > 0) {
-            if (currentState == MENU) {
-                if (buf[0] == 'w' || (buf[0] == '\033' && buf[2] == 'A')) {
-                    menuSelection = (menuSelection - 1 + 3) % 3;
-                }
-                else if (buf[0] == 's' || (buf[0] == '\033' && buf[2] == 'B')) {
-                    menuSelection = (menuSelection + 1) % 3;
-                }
-                else if (buf[0] == '\n' || buf[0] == ' ') {
-                    if (menuSelection == 0) {
-                        currentState = GAME;
-                        resetGame();
-                    } else if (menuSelection == 1) {
-                        currentState = SETTINGS;
-                    } else {
-                        exit(0);
-                    }
-                }
-            }
-            else if (currentState == SETTINGS) {
-                 if (buf[0] == 'w' || (buf[0] == '\033' && buf[2] == 'A')) {
-                    settingsSelection = (settingsSelection - 1 + 3) % 3;
-                }
-                else if (buf[0] == 's' || (buf[0] == '\033' && buf[2] == 'B')) {
-                    settingsSelection = (settingsSelection + 1) % 3;
-                }
-                else if (buf[0] == 'a' || (buf[0] == '\033' && buf[2] == 'D')) {
-                    if(settingsSelection == 0) setSpeedIndex = (setSpeedIndex - 1 + 4) % 4;
-                    if(settingsSelection == 1) setGhostCount = (setGhostCount > 0) ? setGhostCount - 1 : 4;
-                }
-                else if (buf[0] == 'd' || (buf[0] == '\033' && buf[2] == 'C')) {
-                    if(settingsSelection == 0) setSpeedIndex = (setSpeedIndex + 1) % 4;
-                    if(settingsSelection == 1) setGhostCount = (setGhostCount < 10) ? setGhostCount + 1 : 0;
-                }
-                else if (buf[0] == '\n' || buf[0] == ' ') {
-                    if(settingsSelection == 2) currentState = MENU;
-                }
-            }
-            else if (currentState == GAME) {
-                if (buf[0] == 'q') currentState = MENU;
-                else if (buf[0] == 'w') nextDir = {0, -1};
-                else if (buf[0] == 's') nextDir = {0, 1};
-                else if (buf[0] == 'a') nextDir = {-1, 0};
-                else if (buf[0] == 'd') nextDir = {1, 0};
-                else if (buf[0] == '\033' && n >= 3) {
-                    switch(buf[2]) {
-                        case 'A': nextDir = {0, -1}; break;
-                        case 'B': nextDir = {0, 1}; break;
-                        case 'C': nextDir = {1, 0}; break;
-                        case 'D': nextDir = {-1, 0}; break;
-                    }
-                }
-            }
-            else if (currentState == GAME_OVER) {
-                if (buf[0] == 'q') currentState = MENU;
-                if (buf[0] == 'r') {
-                    currentState = GAME;
-                    resetGame();
-                }
-            }
-        }
+    void steer(Action a) {
+        if (a != ACT_NONE) nextDir = ACTION_DIRS[a];
     }
 
-    bool isWall(int x, int y) {
-        if(x < 0 || x >= w || y < 0 || y >= h) return true;
-        return map[y][x] == '#';
-    }
+    void step() {
+        if (over) return;
 
-    void updateGame() {
         if (isPowered) {
             powerTimer--;
             if(powerTimer <= 0) isPowered = false;
@@ -255,25 +179,28 @@ public:
             player.y += dir.y;
         }
 
-        char cell = map[player.y][player.x];
+        char& cell = tile(player.x, player.y);
         if (cell == '.') {
-            map[player.y][player.x] = ' ';
+            cell = ' ';
+            dotsLeft--;
             score += 10;
         } else if (cell == '*') {
-            map[player.y][player.x] = ' ';
+            cell = ' ';
+            powerLeft--;
             score += 50;
             isPowered = true;
             powerTimer = POWER_DURATION;
         }
 
         for(auto& g : ghosts) {
-            if ((g.dir.x == 0 && g.dir.y == 0) || isWall(g.pos.x + g.dir.x, g.pos.y + g.dir.y) || (rand() % 10 == 0)) {
-                vector<Point> moves;
-                if(!isWall(g.pos.x+1, g.pos.y)) moves.push_back({1, 0});
-                if(!isWall(g.pos.x-1, g.pos.y)) moves.push_back({-1, 0});
-                if(!isWall(g.pos.x, g.pos.y+1)) moves.push_back({0, 1});
-                if(!isWall(g.pos.x, g.pos.y-1)) moves.push_back({0, -1});
-                if(!moves.empty()) g.dir = moves[rand() % moves.size()];
+            if ((g.dir.x == 0 && g.dir.y == 0) || isWall(g.pos.x + g.dir.x, g.pos.y + g.dir.y) || (rng() % 10 == 0)) {
+                Point moves[4];
+                int count = 0;
+                if(!isWall(g.pos.x+1, g.pos.y)) moves[count++] = {1, 0};
+                if(!isWall(g.pos.x-1, g.pos.y)) moves[count++] = {-1, 0};
+                if(!isWall(g.pos.x, g.pos.y+1)) moves[count++] = {0, 1};
+                if(!isWall(g.pos.x, g.pos.y-1)) moves[count++] = {0, -1};
+                if(count > 0) g.dir = moves[rng() % count];
             }
             g.pos.x += g.dir.x;
             g.pos.y += g.dir.y;
@@ -281,113 +208,523 @@ public:
             if (g.pos.x == player.x && g.pos.y == player.y) {
                 if (isPowered) {
                     score += 200;
-                    g.pos = ghostSpawn; 
+                    g.pos = tpl->ghostSpawn;
                 } else {
-                    currentState = GAME_OVER;
+                    over = true;
+                }
+            }
+        }
+
+        if(dotsLeft + powerLeft == 0) {
+            over = true;
+            win = true;
+        }
+    }
+
+    int obsSize() const { return w * h; }
+
+    // One byte per tile: low two bits are the static tile, upper bits flag actors.
+    void encode(uint8_t* out) const {
+        for(int i=0; i<w*h; i++) {
+            char c = tiles[i];
+            out[i] = (c == '#') ? OBS_WALL : (c == '.') ? OBS_DOT : (c == '*') ? OBS_POWER : OBS_EMPTY;
+        }
+        out[player.y * w + player.x] |= OBS_PLAYER;
+        for(const auto& g : ghosts) {
+            if(g.pos.x < 0 || g.pos.x >= w || g.pos.y < 0 || g.pos.y >= h) continue;
+            out[g.pos.y * w + g.pos.x] |= isPowered ? (OBS_GHOST | OBS_FRIGHTENED) : OBS_GHOST;
+        }
+    }
+};
+
+// Many independent simulations advanced in lockstep. Each env owns its RNG
+// (seeded from baseSeed + index) and auto-resets when its episode ends.
+// Envs are split into contiguous slices, one per pool thread, so each
+// thread touches its own cache lines.
+class PacmanVecEnv {
+    vector<PacmanSim> envs;
+    vector<uint32_t> episodes;
+    uint32_t baseSeed;
+    WorkerPool pool;
+
+    const uint8_t* curActions = nullptr;
+    uint8_t* curObs = nullptr;
+    int32_t* curRewards = nullptr;
+    uint8_t* curDones = nullptr;
+
+    uint32_t seedFor(int i) const {
+        return (baseSeed ^ ((uint32_t)i * 2654435761u) ^ (episodes[i] * 40503u)) | 1u;
+    }
+
+    void runSlice(int slice) {
+        int n = envs.size();
+        int parts = pool.size();
+        int begin = (long long)n * slice / parts;
+        int end = (long long)n * (slice + 1) / parts;
+        int obsSize = envs.empty() ? 0 : envs[0].obsSize();
+
+        for(int i=begin; i<end; i++) {
+            PacmanSim& e = envs[i];
+            if (curActions) {
+                int before = e.score;
+                e.steer((Action)(curActions[i] % ACTION_COUNT));
+                e.step();
+                if (curRewards) curRewards[i] = e.score - before;
+                if (curDones) curDones[i] = e.over ? (e.win ? 2 : 1) : 0;
+                if (e.over) {
+                    episodes[i]++;
+                    e.reset(seedFor(i));
                 }
             }
+            if (curObs) e.encode(curObs + (size_t)i * obsSize);
+        }
+    }
+
+    void dispatch() {
+        pool.run(pool.size(), [this](int slice, int) { runSlice(slice); });
+    }
+
+    static int threadsFor(int numEnvs, int numThreads) {
+        return max(1, min(numThreads, numEnvs));
+    }
+
+public:
+    PacmanVecEnv(int numEnvs, int numThreads, uint32_t seed, int ghostCount = 4, const MapTemplate& tpl = classicMap())
+        : envs(numEnvs, PacmanSim(tpl, ghostCount)), episodes(numEnvs, 0), baseSeed(seed),
+          pool(threadsFor(numEnvs, numThreads)) {
+        for(int i=0; i<numEnvs; i++) envs[i].reset(seedFor(i));
+    }
+
+    int size() const { return envs.size(); }
+    int threads() const { return pool.size(); }
+    int obsSize() const { return envs.empty() ? 0 : envs[0].obsSize(); }
+    const PacmanSim& env(int i) const { return envs[i]; }
+
+    void observe(uint8_t* obs) {
+        curActions = nullptr; curObs = obs; curRewards = nullptr; curDones = nullptr;
+        dispatch();
+    }
+
+    // actions: one per env. obs: size() * obsSize() bytes (may be null).
+    // rewards: score gained this step. dones: 0 running, 1 died, 2 cleared.
+    void step(const uint8_t* actions, uint8_t* obs, int32_t* rewards, uint8_t* dones) {
+        curActions = actions; curObs = obs; curRewards = rewards; curDones = dones;
+        dispatch();
+    }
+};
+
+// Bounded-horizon autopilot. Walls never change, so shortest-path distances
+// between all walkable tiles are computed once. The danger map (earliest
+// tick any ghost can reach a tile) is rebuilt whenever a ghost has moved, as
+// the minimum of every ghost's precomputed row; all ghosts move on every
+// step, so tracking which ones moved would not save a row. The pellet
+// distance field is rebuilt only when a pellet was eaten. The search is an
+// iterative-deepening DFS over player moves that stops at the time budget
+// and keeps the last fully searched depth.
+class PacmanPlanner {
+    static constexpr uint16_t FAR = 0xFFFF;
+
+    const MapTemplate* tpl = nullptr;
+    int w = 0, h = 0;
+    vector<uint16_t> dist;
+    vector<uint16_t> danger;
+    vector<uint16_t> pelletDist;
+    vector<Point> lastGhosts;
+    int lastPellets = -1;
+    bool lastPowered = false;
+
+    vector<char> eaten;
+    const PacmanSim* cur = nullptr;
+    chrono::steady_clock::time_point deadline;
+    long long nodes = 0;
+    bool aborted = false;
+
+    void bfs(const vector<int>& sources, uint16_t* out) {
+        fill(out, out + w * h, FAR);
+        vector<int> queue(sources);
+        for(int s : sources) out[s] = 0;
+        for(size_t qi = 0; qi < queue.size(); qi++) {
+            int p = queue[qi];
+            int x = p % w, y = p / w;
+            for(int a = ACT_UP; a < ACTION_COUNT; a++) {
+                int nx = x + ACTION_DIRS[a].x, ny = y + ACTION_DIRS[a].y;
+                if(nx < 0 || nx >= w || ny < 0 || ny >= h) continue;
+                int np = ny * w + nx;
+                if(tpl->tiles[np] == '#' || out[np] != FAR) continue;
+                out[np] = out[p] + 1;
+                queue.push_back(np);
+            }
+        }
+    }
+
+    void prepare(const MapTemplate& t) {
+        tpl = &t;
+        w = t.w;
+        h = t.h;
+        dist.assign((size_t)w * h * w * h, FAR);
+        for(int p=0; p<w*h; p++) {
+            if(t.tiles[p] == '#') continue;
+            bfs({p}, &dist[(size_t)p * w * h]);
+        }
+        danger.assign(w * h, FAR);
+        pelletDist.assign(w * h, FAR);
+        eaten.assign(w * h, 0);
+        lastGhosts.clear();
+        lastPellets = -1;
+    }
+
+    void refresh(const PacmanSim& sim) {
+        bool ghostsMoved = lastGhosts.size() != sim.ghosts.size() || lastPowered != sim.isPowered;
+        for(size_t i=0; !ghostsMoved && i<sim.ghosts.size(); i++) {
+            ghostsMoved = lastGhosts[i].x != sim.ghosts[i].pos.x || lastGhosts[i].y != sim.ghosts[i].pos.y;
+        }
+        if (ghostsMoved) {
+            lastGhosts.resize(sim.ghosts.size());
+            fill(danger.begin(), danger.end(), FAR);
+            for(size_t i=0; i<sim.ghosts.size(); i++) {
+                Point g = sim.ghosts[i].pos;
+                lastGhosts[i] = g;
+                const uint16_t* row = &dist[(size_t)(g.y * w + g.x) * w * h];
+                for(int p=0; p<w*h; p++) danger[p] = min(danger[p], row[p]);
+            }
+            lastPowered = sim.isPowered;
         }
 
-        bool dotsLeft = false;
-        for(const auto& row : map) if(row.find('.') != string::npos || row.find('*') != string::npos) dotsLeft = true;
-        if(!dotsLeft) { 
-            currentState = GAME_OVER; 
-            win = true; 
+        int pellets = sim.dotsLeft + sim.powerLeft;
+        if (pellets != lastPellets) {
+            vector<int> sources;
+            for(int p=0; p<w*h; p++) if(sim.tiles[p] == '.' || sim.tiles[p] == '*') sources.push_back(p);
+            bfs(sources, pelletDist.data());
+            lastPellets = pellets;
         }
     }
 
-    void cursorTo(string& buf, int r, int c) {
-        buf += "\033[" + to_string(padTop + r) + ";" + to_string(padLeft + c) + "H";
+    double evaluate(int p, int t, int powerLeft) {
+        double value = 0;
+        char c = cur->tiles[p];
+        if (!eaten[p]) {
+            if (c == '.') value += 10;
+            else if (c == '*') value += (danger[p] < 12 ? 120 : 30);
+        }
+
+        int margin = (int)danger[p] - t;
+        if (powerLeft > t + 1) {
+            if (margin <= 0) value += 200;
+        } else if (margin <= 0) {
+            value -= (t <= 2) ? 100000 : 4000.0 / t;
+        } else if (margin < 3) {
+            value -= 60.0 / margin;
+        }
+        return value;
+    }
+
+    double search(int p, int prev, int t, int depth, int powerLeft) {
+        if ((++nodes & 63) == 0 && chrono::steady_clock::now() > deadline) aborted = true;
+        if (aborted) return 0;
+
+        if (depth == 0) {
+            uint16_t d = pelletDist[p];
+            return d == FAR ? 0 : -2.0 * d;
+        }
+
+        double best = -1e18;
+        int x = p % w, y = p / w;
+        for(int a = ACT_UP; a < ACTION_COUNT; a++) {
+            int nx = x + ACTION_DIRS[a].x, ny = y + ACTION_DIRS[a].y;
+            if(cur->isWall(nx, ny)) continue;
+            int np = ny * w + nx;
+            if(np == prev) continue;
+
+            double v = evaluate(np, t + 1, powerLeft);
+            if (v > -50000) {
+                char was = eaten[np];
+                int nextPower = powerLeft;
+                if (!was && cur->tiles[np] == '*') nextPower = POWER_DURATION + t + 1;
+                eaten[np] = 1;
+                v += 0.92 * search(np, p, t + 1, depth - 1, nextPower);
+                eaten[np] = was;
+            }
+            best = max(best, v);
+        }
+        // Dead end: allow turning back rather than reporting no move.
+        if (best == -1e18 && prev >= 0) {
+            double v = evaluate(prev, t + 1, powerLeft);
+            if (v > -50000) v += 0.92 * search(prev, p, t + 1, depth - 1, powerLeft);
+            best = v;
+        }
+        return best;
+    }
+
+public:
+    int lastDepth = 0;
+    long long lastMicros = 0;
+    long long lastNodes = 0;
+    int maxDepth = 40;
+
+    Action plan(const PacmanSim& sim, long long budgetMicros) {
+        auto start = chrono::steady_clock::now();
+        if (tpl != sim.tpl) prepare(*sim.tpl);
+        refresh(sim);
+
+        cur = &sim;
+        deadline = start + chrono::microseconds(budgetMicros);
+        nodes = 0;
+        aborted = false;
+
+        int p = sim.player.y * w + sim.player.x;
+        int powerLeft = sim.isPowered ? sim.powerTimer : 0;
+        Action bestAction = ACT_NONE;
+        lastDepth = 0;
+
+        for(int depth = 1; depth <= maxDepth && !aborted; depth++) {
+            Action depthBest = ACT_NONE;
+            double depthScore = -1e18;
+            for(int a = ACT_UP; a < ACTION_COUNT; a++) {
+                int nx = sim.player.x + ACTION_DIRS[a].x, ny = sim.player.y + ACTION_DIRS[a].y;
+                if(sim.isWall(nx, ny)) continue;
+                int np = ny * w + nx;
+
+                double v = evaluate(np, 1, powerLeft);
+                char was = eaten[np];
+                int nextPower = (!was && sim.tiles[np] == '*') ? POWER_DURATION + 1 : powerLeft;
+                eaten[np] = 1;
+                v += 0.92 * search(np, p, 1, depth - 1, nextPower);
+                eaten[np] = was;
+                if (aborted) break;
+                if (v > depthScore) { depthScore = v; depthBest = (Action)a; }
+            }
+            if (aborted) break;
+            bestAction = depthBest;
+            lastDepth = depth;
+        }
+
+        lastNodes = nodes;
+        lastMicros = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+        return bestAction;
+    }
+};
+
+class PacmanGame {
+    enum State { MENU, SETTINGS, GAME, GAME_OVER };
+    State currentState;
+    
+    int menuSelection;
+    int settingsSelection;
+
+    PacmanSim sim;
+    int w, h;
+
+    int setSpeedIndex; 
+    int setGhostCount;
+    int gameSpeedDelay;
+
+    bool autopilot;
+    PacmanPlanner planner;
+
+    int padTop, padLeft;
+
+public:
+    PacmanGame() {
+        w = sim.w;
+        h = sim.h;
+        
+        currentState = MENU;
+        menuSelection = 0;
+        settingsSelection = 0;
+        
+        setSpeedIndex = 1; 
+        setGhostCount = 4;
+        autopilot = false;
+        
+        resetGame();
+    }
+
+    void enter() {
+        currentState = MENU;
+        menuSelection = 0;
+    }
+
+    void resetGame() {
+        sim.ghostCount = setGhostCount;
+        sim.reset(rand());
+
+        int speeds[] = { 130000, 90000, 60000, 30000 };
+        gameSpeedDelay = speeds[setSpeedIndex];
     }
 
-    void drawButton(string& buf, int r, string text, bool selected) {
+    // The game moves one step per tick, at the speed setting's pace; the
+    // menus and the end screen wait for keys.
+    int tickInterval() const {
+        return currentState == GAME ? gameSpeedDelay / 1000 : 0;
+    }
+
+    void tick() {
+        if (currentState == GAME) updateGame();
+    }
+
+    void calculateLayout(WINDOW* win) {
+        int gameWidth = (w * 2) + 4;
+        int gameHeight = h + 6;
+
+        padTop = (getmaxy(win) - gameHeight) / 2;
+        padLeft = (getmaxx(win) - gameWidth) / 2;
+        if(padTop < 0) padTop = 0;
+        if(padLeft < 0) padLeft = 0;
+    }
+
+    // False when the player picks EXIT from the main menu.
+    bool handleKey(int ch) {
+        bool select = (ch == '\n' || ch == KEY_ENTER || ch == ' ');
+
+        if (currentState == MENU) {
+            if (ch == 'w' || ch == KEY_UP) {
+                menuSelection = (menuSelection - 1 + 3) % 3;
+            }
+            else if (ch == 's' || ch == KEY_DOWN) {
+                menuSelection = (menuSelection + 1) % 3;
+            }
+            else if (select) {
+                if (menuSelection == 0) {
+                    currentState = GAME;
+                    resetGame();
+                } else if (menuSelection == 1) {
+                    currentState = SETTINGS;
+                } else {
+                    return false;
+                }
+            }
+        }
+        else if (currentState == SETTINGS) {
+            if (ch == 'w' || ch == KEY_UP) {
+                settingsSelection = (settingsSelection - 1 + 4) % 4;
+            }
+            else if (ch == 's' || ch == KEY_DOWN) {
+                settingsSelection = (settingsSelection + 1) % 4;
+            }
+            else if (ch == 'a' || ch == KEY_LEFT) {
+                if(settingsSelection == 0) setSpeedIndex = (setSpeedIndex - 1 + 4) % 4;
+                if(settingsSelection == 1) setGhostCount = (setGhostCount > 0) ? setGhostCount - 1 : 4;
+                if(settingsSelection == 2) autopilot = !autopilot;
+            }
+            else if (ch == 'd' || ch == KEY_RIGHT) {
+                if(settingsSelection == 0) setSpeedIndex = (setSpeedIndex + 1) % 4;
+                if(settingsSelection == 1) setGhostCount = (setGhostCount < 10) ? setGhostCount + 1 : 0;
+                if(settingsSelection == 2) autopilot = !autopilot;
+            }
+            else if (select) {
+                if(settingsSelection == 2) autopilot = !autopilot;
+                if(settingsSelection == 3) currentState = MENU;
+            }
+        }
+        else if (currentState == GAME) {
+            if (ch == 'q') currentState = MENU;
+            else if (ch == 'p') autopilot = !autopilot;
+            else if (ch == 'w' || ch == KEY_UP) sim.steer(ACT_UP);
+            else if (ch == 's' || ch == KEY_DOWN) sim.steer(ACT_DOWN);
+            else if (ch == 'a' || ch == KEY_LEFT) sim.steer(ACT_LEFT);
+            else if (ch == 'd' || ch == KEY_RIGHT) sim.steer(ACT_RIGHT);
+        }
+        else if (currentState == GAME_OVER) {
+            if (ch == 'q') currentState = MENU;
+            if (ch == 'r') {
+                currentState = GAME;
+                resetGame();
+            }
+        }
+        return true;
+    }
+
+    void updateGame() {
+        if (autopilot) sim.steer(planner.plan(sim, gameSpeedDelay / 4));
+        sim.step();
+        if (sim.over) currentState = GAME_OVER;
+    }
+
+    static int color(Pair pair) {
+        return pair == PAIR_SELECTED ? COLOR_PAIR(pair) : COLOR_PAIR(pair) | A_BOLD;
+    }
+
+    void put(WINDOW* win, int r, int c, const string& text, Pair pair) {
+        wattron(win, color(pair));
+        mvwaddstr(win, padTop + r, padLeft + c, text.c_str());
+        wattroff(win, color(pair));
+    }
+
+    void drawButton(WINDOW* win, int r, string text, bool selected) {
         int width = w * 2;
         int textLen = text.length();
         int btnWidth = textLen + 4;
         int startCol = (width - btnWidth) / 2;
         
-        cursorTo(buf, r, startCol);
-        
-        if (selected) {
-            buf += string(BG_WHITE) + BLACK_TXT + "  " + text + "  " + RESET;
-        } else {
-            buf += string(BG_BLACK) + WHITE + "  " + text + "  " + RESET;
-        }
+        put(win, r, startCol, "  " + text + "  ", selected ? PAIR_SELECTED : PAIR_WHITE);
     }
 
-    void drawFrame(string& buf, int heightOffset = 0) {
-        cursorTo(buf, 0, 0);
-        buf += GRAY "╔";
-        for(int i=0; i<w*2; i++) buf += "═";
-        buf += "╗" RESET;
+    void drawFrame(WINDOW* win, int heightOffset = 0) {
+        string bar;
+        for(int i=0; i<w*2; i++) bar += "═";
 
+        put(win, 0, 0, "╔" + bar + "╗", PAIR_GRAY);
         for(int y=0; y<h + heightOffset; y++) {
-            cursorTo(buf, y + 1, 0);
-            buf += GRAY "║" RESET;
-            cursorTo(buf, y + 1, (w*2) + 1);
-            buf += GRAY "║" RESET;
+            put(win, y + 1, 0, "║", PAIR_GRAY);
+            put(win, y + 1, (w*2) + 1, "║", PAIR_GRAY);
         }
-
-        cursorTo(buf, h + heightOffset + 1, 0);
-        buf += GRAY "╚";
-        for(int i=0; i<w*2; i++) buf += "═";
-        buf += "╝" RESET;
+        put(win, h + heightOffset + 1, 0, "╚" + bar + "╝", PAIR_GRAY);
     }
 
-    void draw() {
-        calculateLayout();
-        string buffer = "\033[2J"; 
+    void render(WINDOW* win) {
+        calculateLayout(win);
+        werase(win);
 
         if (currentState == MENU) {
-            drawFrame(buffer);
+            drawFrame(win);
             
             string title = "PAC-MAN";
-            cursorTo(buffer, 4, (w*2 - title.length())/2);
-            buffer += YELLOW + title + RESET;
+            put(win, 4, (w*2 - title.length())/2, title, PAIR_YELLOW);
 
-            drawButton(buffer, 8, "START GAME", menuSelection == 0);
-            drawButton(buffer, 11, "SETTINGS", menuSelection == 1);
-            drawButton(buffer, 14, "EXIT", menuSelection == 2);
+            drawButton(win, 8, "START GAME", menuSelection == 0);
+            drawButton(win, 11, "SETTINGS", menuSelection == 1);
+            drawButton(win, 14, "EXIT", menuSelection == 2);
         } 
         else if (currentState == SETTINGS) {
-            drawFrame(buffer);
+            drawFrame(win);
 
             string title = "SETTINGS";
-            cursorTo(buffer, 3, (w*2 - title.length())/2);
-            buffer += BLUE + title + RESET;
+            put(win, 3, (w*2 - title.length())/2, title, PAIR_BLUE);
 
             string speeds[] = {"SLOW", "NORMAL", "FAST", "INSANE"};
             string spd = "SPEED: < " + speeds[setSpeedIndex] + " >";
-            drawButton(buffer, 7, spd, settingsSelection == 0);
+            drawButton(win, 6, spd, settingsSelection == 0);
 
             string gcount = "GHOSTS: < " + to_string(setGhostCount) + " >";
-            drawButton(buffer, 10, gcount, settingsSelection == 1);
+            drawButton(win, 9, gcount, settingsSelection == 1);
 
-            drawButton(buffer, 14, "BACK", settingsSelection == 2);
+            string apText = string("AUTOPILOT: < ") + (autopilot ? "ON" : "OFF") + " >";
+            drawButton(win, 12, apText, settingsSelection == 2);
+
+            drawButton(win, 15, "BACK", settingsSelection == 3);
         }
         else {
-            drawFrame(buffer);
+            drawFrame(win);
 
             for(int y=0; y<h; y++) {
-                cursorTo(buffer, y + 1, 2);
                 for(int x=0; x<w; x++) {
+                    int col = 1 + x * 2;
                     bool dynamic = false;
                     
-                    if(x == player.x && y == player.y) {
+                    if(x == sim.player.x && y == sim.player.y) {
                         string pChar = " O";
-                        if(dir.x == 1)      pChar = " <";
-                        else if(dir.x == -1) pChar = " >";
-                        else if(dir.y == -1) pChar = " v";
-                        else if(dir.y == 1)  pChar = " ^";
+                        if(sim.dir.x == 1)      pChar = " <";
+                        else if(sim.dir.x == -1) pChar = " >";
+                        else if(sim.dir.y == -1) pChar = " v";
+                        else if(sim.dir.y == 1)  pChar = " ^";
                         
-                        buffer += YELLOW + pChar + RESET;
+                        put(win, y + 1, col, pChar, PAIR_YELLOW);
                         dynamic = true;
                     } 
                     else {
-                        for(const auto& g : ghosts) {
+                        for(const auto& g : sim.ghosts) {
                             if(g.pos.x == x && g.pos.y == y) {
-                                if (isPowered) buffer += CYAN + GHOST_CHAR + RESET;
-                                else buffer += RED + GHOST_CHAR + RESET;
+                                put(win, y + 1, col, GHOST_CHAR, sim.isPowered ? PAIR_CYAN : PAIR_RED);
                                 dynamic = true;
                                 break;
                             }
@@ -395,21 +732,24 @@ public:
                     }
 
                     if(!dynamic) {
-                        char c = map[y][x];
-                        if(c == '#') buffer += BLUE + WALL_CHAR + RESET;
-                        else if(c == '.') buffer += WHITE + DOT_CHAR + RESET;
-                        else if(c == '*') buffer += GREEN + POWER_CHAR + RESET;
-                        else buffer += EMPTY_CHAR;
+                        char c = sim.tile(x, y);
+                        if(c == '#') put(win, y + 1, col, WALL_CHAR, PAIR_BLUE);
+                        else if(c == '.') put(win, y + 1, col, DOT_CHAR, PAIR_WHITE);
+                        else if(c == '*') put(win, y + 1, col, POWER_CHAR, PAIR_GREEN);
                     }
                 }
             }
 
-            string sText = "SCORE: " + to_string(score);
-            cursorTo(buffer, h + 2, (w*2 - sText.length())/2);
-            buffer += WHITE + sText + RESET;
+            string sText = "SCORE: " + to_string(sim.score);
+            put(win, h + 2, (w*2 - sText.length())/2, sText, PAIR_WHITE);
+
+            if (autopilot) {
+                string aText = "AUTO  PLAN: " + to_string(planner.lastMicros) + "us  DEPTH: " + to_string(planner.lastDepth);
+                put(win, h + 3, (w*2 - aText.length())/2, aText, PAIR_CYAN);
+            }
 
             if (currentState == GAME_OVER) {
-                string msg = win ? "YOU WIN!" : "GAME OVER";
+                string msg = sim.win ? "YOU WIN!" : "GAME OVER";
                 string sub = "R - Retry | Q - Menu";
                 
                 int boxWidth = sub.length() + 4;
@@ -418,37 +758,88 @@ public:
                 int startX = (w*2 - boxWidth) / 2;
 
                 for(int i=0; i<boxHeight; i++) {
-                    cursorTo(buffer, startY + i, startX);
-                    buffer += BG_BLACK;
-                    for(int j=0; j<boxWidth; j++) buffer += " ";
-                    buffer += RESET;
+                    put(win, startY + i, startX, string(boxWidth, ' '), PAIR_WHITE);
                 }
 
-                cursorTo(buffer, startY + 1, (w*2 - msg.length()) / 2);
-                buffer += string(win ? GREEN : RED) + BG_BLACK + msg + RESET;
-                
-                cursorTo(buffer, startY + 3, (w*2 - sub.length()) / 2);
-                buffer += string(WHITE) + BG_BLACK + sub + RESET;
+                put(win, startY + 1, (w*2 - msg.length()) / 2, msg, sim.win ? PAIR_GREEN : PAIR_RED);
+                put(win, startY + 3, (w*2 - sub.length()) / 2, sub, PAIR_WHITE);
             }
         }
+    }
+};
 
-        cout << buffer << flush;
+PacmanGame game;
+
+void init() {
+    srand(time(0));
+    game.enter();
+
+    if (has_colors()) {
+        init_pair(PAIR_YELLOW, COLOR_YELLOW, COLOR_BLACK);
+        init_pair(PAIR_BLUE, COLOR_BLUE, COLOR_BLACK);
+        init_pair(PAIR_RED, COLOR_RED, COLOR_BLACK);
+        init_pair(PAIR_CYAN, COLOR_CYAN, COLOR_BLACK);
+        init_pair(PAIR_GREEN, COLOR_GREEN, COLOR_BLACK);
+        init_pair(PAIR_WHITE, COLOR_WHITE, COLOR_BLACK);
+        // Bright black where the terminal has sixteen colors.
+        init_pair(PAIR_GRAY, COLORS >= 16 ? 8 : COLOR_WHITE, COLOR_BLACK);
+        init_pair(PAIR_SELECTED, COLOR_BLACK, COLOR_WHITE);
     }
+}
+
+bool handleKey(int ch) { return game.handleKey(ch); }
+void tick() { game.tick(); }
+void render(WINDOW* win) { game.render(win); }
+int tickInterval() { return game.tickInterval(); }
+void teardown() {}
+
+const GamePlugin plugin = {
+    GAME_PLUGIN_ABI_VERSION, "pacman", 0, init, handleKey, tick, render, teardown, tickInterval,
+};
+
+extern "C" const GamePlugin* game_plugin() { return &plugin; }
+
+int runBenchmark(int numEnvs, int steps, int numThreads, uint32_t seed) {
+    PacmanVecEnv vec(numEnvs, numThreads, seed);
+    vector<uint8_t> actions(numEnvs, ACT_NONE);
+    vector<uint8_t> obs((size_t)numEnvs * vec.obsSize());
+    vector<int32_t> rewards(numEnvs);
+    vector<uint8_t> dones(numEnvs);
+    minstd_rand actionRng(seed);
 
-    void run() {
-        setupTerminal();
-        while(true) {
-            handleInput();
-            if (currentState == GAME) updateGame();
-            draw();
-            usleep(gameSpeedDelay);
+    long long episodes = 0, wins = 0, totalReward = 0;
+    vec.observe(obs.data());
+
+    auto t0 = chrono::steady_clock::now();
+    for(int s=0; s<steps; s++) {
+        for(int i=0; i<numEnvs; i++) {
+            if (actionRng() % 8 == 0) actions[i] = 1 + actionRng() % 4;
+        }
+        vec.step(actions.data(), obs.data(), rewards.data(), dones.data());
+        for(int i=0; i<numEnvs; i++) {
+            totalReward += rewards[i];
+            if (dones[i]) { episodes++; if (dones[i] == 2) wins++; }
         }
     }
-};
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    double envSteps = (double)numEnvs * steps;
 
-int main() {
-    srand(time(0));
-    PacmanGame game;
-    game.run();
+    cout << "envs: " << numEnvs << "  steps: " << steps << "  threads: " << vec.threads() << endl;
+    cout << "obs bytes/env: " << vec.obsSize() << endl;
+    cout << "episodes: " << episodes << "  wins: " << wins << "  reward: " << totalReward << endl;
+    cout << "time: " << secs << " s  steps/sec: " << (long long)(envSteps / (secs > 0 ? secs : 1e-9)) << endl;
     return 0;
 }
+
+int main(int argc, char** argv) {
+    if (argc > 1 && string(argv[1]) == "--bench") {
+        int numEnvs = argc > 2 ? atoi(argv[2]) : 4096;
+        int steps = argc > 3 ? atoi(argv[3]) : 1000;
+        int numThreads = argc > 4 ? atoi(argv[4]) : (int)max(1u, thread::hardware_concurrency());
+        uint32_t seed = argc > 5 ? (uint32_t)strtoul(argv[5], nullptr, 10) : 12345;
+        return runBenchmark(max(1, numEnvs), max(1, steps), max(1, numThreads), seed);
+    }
+
+    setlocale(LC_ALL, "");
+    return runGamePlugin(&plugin);
+}
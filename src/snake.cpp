@@ -2,10 +2,25 @@
 #include <vector>
 #include <cstdlib>
 #include <ctime>
-#include <unistd.h>
 #include <fstream>
 #include <string>
 #include <cstring>
+#include <cstdint>
+#include <queue>
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <clocale>
+#include "game_plugin.h"
+#include "worker_pool.h"
 
 const char* HIGHSCORE_FILE = "highscore.txt";
 const int MENU_WIDTH = 40;  
@@ -15,25 +30,277 @@ struct Point {
     int x, y;
 };
 
+enum Pilot { PILOT_OFF, PILOT_CYCLE, PILOT_AI, PILOT_COUNT };
+
+const int ARENA_SIZES[] = {0, 10, 25, 50, 100};
+const int ARENA_SIZE_COUNT = 5;
+
 struct GameConfig {
     int width = 40;
     int height = 20;
     int speedDelay = 90000; 
     int foodCount = 1;
     bool godMode = false;
+    int pilot = PILOT_OFF;
+    int arenaIndex = 0;  // opponents: ARENA_SIZES[arenaIndex]
     
     int sizeIndex = 1;  
     int speedIndex = 1; 
 };
 
 GameConfig config;
-int score = 0;
 int highScore = 0;
-bool gameOver = false;
-int dirX = 1, dirY = 0;
+bool autopilotReady = false;  // a Hamiltonian cycle fits the current board
+std::vector<float> aiPolicy;  // AI pilot weights, empty until a policy file loads
+std::vector<float> aiHidden;  // policyActions() scratch for the pilot
+
+// The body lives in a power-of-two ring buffer, so a move is a head push and
+// a tail pop with no shifting. Segment 0 is the head.
+struct SnakeBody {
+    std::vector<Point> ring;
+    size_t mask = 0, head = 0, length = 0;
+
+    void reset(size_t capacity) {
+        size_t size = 1;
+        while (size < capacity) size <<= 1;
+        ring.assign(size, Point{0, 0});
+        mask = size - 1;
+        head = length = 0;
+    }
+
+    size_t size() const { return length; }
+    const Point& operator[](size_t i) const { return ring[(head + i) & mask]; }
+    const Point& front() const { return ring[head]; }
+    const Point& back() const { return ring[(head + length - 1) & mask]; }
+
+    void pushFront(Point p) {
+        if (length == ring.size()) grow();
+        head = (head - 1) & mask;
+        ring[head] = p;
+        length++;
+    }
+
+    void popBack() { length--; }
+
+    // Reached whenever a body outgrows its starting ring, which is kept small
+    // on big boards and for arena snakes; in God Mode a body can even outgrow
+    // the board.
+    void grow() {
+        std::vector<Point> bigger(ring.size() * 2);
+        for (size_t i = 0; i < length; i++) bigger[i] = (*this)[i];
+        ring.swap(bigger);
+        mask = ring.size() - 1;
+        head = 0;
+    }
+};
+
+// Interior cells holding neither body nor food, as a dense array plus each
+// cell's slot in it: spawning food is one uniform pick, and every update is
+// an append or a swap-remove.
+struct FreeCellIndex {
+    std::vector<int> cells;
+    std::vector<int> slot;  // -1 when the cell is taken (or a wall)
+
+    void reset(int boardCells) {
+        cells.clear();
+        slot.assign(boardCells, -1);
+    }
+
+    bool empty() const { return cells.empty(); }
+    size_t size() const { return cells.size(); }
+    int pick(std::minstd_rand& rng) const { return cells[rng() % cells.size()]; }
+
+    void take(int cell) {
+        int at = slot[cell];
+        if (at < 0) return;
+        int last = cells.back();
+        cells[at] = last;
+        slot[last] = at;
+        cells.pop_back();
+        slot[cell] = -1;
+    }
+
+    void release(int cell) {
+        if (slot[cell] >= 0) return;
+        slot[cell] = cells.size();
+        cells.push_back(cell);
+    }
+};
+
+// The whole game state, with no terminal and no global RNG: the UI, the
+// autopilot benchmark and the trainer's thousands of concurrent games all
+// advance the same struct. Each game owns its RNG, seeded per game.
+struct SnakeSim {
+    int width = 0, height = 0;
+    bool godMode = false;
+
+    SnakeBody snake;
+    std::vector<Point> fruits;
+
+    // Body segments and food per board cell, so collision and food checks are a
+    // single lookup. Segments are counted rather than flagged because God Mode
+    // lets the snake cross itself.
+    std::vector<uint16_t> occupancy;
+    std::vector<uint8_t> foodAt;
+
+    FreeCellIndex freeCells;
+
+    int score = 0;
+    int dirX = 1, dirY = 0;
+    bool over = false;
+    bool victory = false;
+    std::minstd_rand rng;
+
+    // Cells whose contents changed since the renderer last looked, so it only
+    // repaints those. Off for headless games, which nobody drains.
+    bool trackChanges = false;
+    std::vector<int> touched;
+
+    // Body segments per 2^coarseShift square, for the minimap; kept only
+    // when coarseShift is set before reset().
+    int coarseShift = -1, coarseWidth = 0;
+    std::vector<int> coarse;
+    bool coarseChanged = false;
+
+    int cellIndex(Point p) const {
+        return p.y * width + p.x;
+    }
+
+    void touch(int cell) {
+        if (trackChanges) touched.push_back(cell);
+    }
+
+    void countCoarse(Point p, int delta) {
+        if (coarse.empty()) return;
+        int& n = coarse[(p.y >> coarseShift) * coarseWidth + (p.x >> coarseShift)];
+        n += delta;
+        if (n == (delta > 0 ? 1 : 0)) coarseChanged = true;
+    }
+
+    void addHead(Point p) {
+        if (snake.size() > 0) touch(cellIndex(snake.front()));
+        snake.pushFront(p);
+        occupancy[cellIndex(p)]++;
+        freeCells.take(cellIndex(p));
+        touch(cellIndex(p));
+        countCoarse(p, 1);
+    }
+
+    void removeTail() {
+        int cell = cellIndex(snake.back());
+        if (--occupancy[cell] == 0 && !foodAt[cell]) freeCells.release(cell);
+        countCoarse(snake.back(), -1);
+        snake.popBack();
+        touch(cell);
+    }
+
+    void placeFood(size_t i, Point p) {
+        fruits[i] = p;
+        foodAt[cellIndex(p)] = 1;
+        freeCells.take(cellIndex(p));
+        touch(cellIndex(p));
+    }
+
+    // False once the snake and food cover the whole board.
+    bool getRandomEmptyPosition(Point& p) {
+        if (freeCells.empty()) return false;
+        int cell = freeCells.pick(rng);
+        p = {cell % width, cell / width};
+        return true;
+    }
+
+    void reset(const GameConfig& cfg, uint32_t seed) {
+        width = cfg.width;
+        height = cfg.height;
+        godMode = cfg.godMode;
+        rng.seed(seed);
+        score = 0;
+        over = victory = false;
+        dirX = 1; dirY = 0;
+        touched.clear();
+        coarse.clear();
+        if (coarseShift >= 0) {
+            coarseWidth = ((width - 1) >> coarseShift) + 1;
+            coarse.assign(coarseWidth * (((height - 1) >> coarseShift) + 1), 0);
+        }
+        // The ring grows on demand, so a huge board does not reserve a body
+        // as large as itself up front.
+        snake.reset(std::min((width - 2) * (height - 2), 4096));
+        occupancy.assign(width * height, 0);
+        foodAt.assign(width * height, 0);
+        fruits.assign(cfg.foodCount, Point{0, 0});
+        freeCells.reset(width * height);
+        for (int y = 1; y < height - 1; y++)
+            for (int x = 1; x < width - 1; x++) freeCells.release(cellIndex({x, y}));
+
+        int startX = width / 2;
+        int startY = height / 2;
+        addHead({startX - 2, startY});
+        addHead({startX - 1, startY});
+        addHead({startX, startY});
+
+        for (int i = 0; i < cfg.foodCount; i++) {
+            Point p;
+            if (!getRandomEmptyPosition(p)) { fruits.resize(i); break; }
+            placeFood(i, p);
+        }
+    }
+
+    void step() {
+        if (over) return;
+        Point newHead = {snake.front().x + dirX, snake.front().y + dirY};
+
+        if (godMode) {
+            if (newHead.x >= width - 1) newHead.x = 1;
+            else if (newHead.x <= 0) newHead.x = width - 2;
+            if (newHead.y >= height - 1) newHead.y = 1;
+            else if (newHead.y <= 0) newHead.y = height - 2;
+        } else {
+            if (newHead.x <= 0 || newHead.x >= width - 1 ||
+                newHead.y <= 0 || newHead.y >= height - 1) {
+                over = true;
+                return;
+            }
+        }
+
+        // The tail cell is fair game: it is vacated this tick, since a body cell
+        // never holds food and the snake cannot be growing into it.
+        int target = cellIndex(newHead);
+        bool chasingTail = target == cellIndex(snake.back()) && occupancy[target] == 1;
+        if (!godMode && occupancy[target] > 0 && !chasingTail) {
+            over = true;
+            return;
+        }
+
+        addHead(newHead);
+
+        bool ate = false;
+        if (foodAt[target]) {
+            foodAt[target] = 0;
+            for (size_t i = 0; i < fruits.size(); i++) {
+                if (newHead.x == fruits[i].x && newHead.y == fruits[i].y) {
+                    score += 10;
+                    ate = true;
+                    Point p;
+                    if (getRandomEmptyPosition(p)) placeFood(i, p);
+                    else { fruits[i] = fruits.back(); fruits.pop_back(); }
+                    break;
+                }
+            }
+        }
+
+        // No food left to spawn or eat means the body covers the board.
+        if (fruits.empty() && freeCells.empty()) {
+            victory = true;
+            over = true;
+            return;
+        }
 
-std::vector<Point> fruits;
-std::vector<Point> snake;
+        if (!ate) removeTail();
+    }
+};
+
+SnakeSim game;
 
 void loadHighScore() {
     std::ifstream file(HIGHSCORE_FILE);
@@ -45,8 +312,8 @@ void loadHighScore() {
     }
 }
 
-void saveHighScore() {
-    if (config.godMode) return;
+void saveHighScore(int score) {
+    if (config.godMode || config.pilot != PILOT_OFF) return;
 
     if (score > highScore) {
         highScore = score;
@@ -58,172 +325,909 @@ void saveHighScore() {
     }
 }
 
-Point getRandomEmptyPosition() {
-    Point p;
-    bool occupied;
-    do {
-        occupied = false;
-        p.x = rand() % (config.width - 2) + 1;
-        p.y = rand() % (config.height - 2) + 1;
-        
-        for (auto& s : snake) {
-            if (s.x == p.x && s.y == p.y) occupied = true;
-        }
-        for (auto& f : fruits) {
-            if (f.x == p.x && f.y == p.y) occupied = true;
-        }
-    } while (occupied);
-    return p;
-}
-
-void initGame() {
-    score = 0;
-    dirX = 1; dirY = 0;
-    snake.clear();
-    fruits.clear();
-    
-    int startX = config.width / 2;
-    int startY = config.height / 2;
-    snake.push_back({startX, startY});
-    snake.push_back({startX - 1, startY});
-    snake.push_back({startX - 2, startY});
-    
-    for (int i = 0; i < config.foodCount; i++) {
-        fruits.push_back(getRandomEmptyPosition());
-    }
-}
-
-void drawBox(int y, int x, int h, int w, const char* title = nullptr) {
-    attron(COLOR_PAIR(3));
-    mvprintw(y, x, "┌");
-    mvprintw(y, x + w - 1, "┐");
-    mvprintw(y + h - 1, x, "└");
-    mvprintw(y + h - 1, x + w - 1, "┘");
+void drawBox(WINDOW* win, int y, int x, int h, int w, const char* title = nullptr) {
+    wattron(win, COLOR_PAIR(3));
+    mvwprintw(win, y, x, "┌");
+    mvwprintw(win, y, x + w - 1, "┐");
+    mvwprintw(win, y + h - 1, x, "└");
+    mvwprintw(win, y + h - 1, x + w - 1, "┘");
 
     for (int i = 1; i < w - 1; i++) {
-        mvprintw(y, x + i, "─");
-        mvprintw(y + h - 1, x + i, "─");
+        mvwprintw(win, y, x + i, "─");
+        mvwprintw(win, y + h - 1, x + i, "─");
     }
     for (int i = 1; i < h - 1; i++) {
-        mvprintw(y + i, x, "│");
-        mvprintw(y + i, x + w - 1, "│");
+        mvwprintw(win, y + i, x, "│");
+        mvwprintw(win, y + i, x + w - 1, "│");
     }
     
     if (title) {
         int titleLen = strlen(title);
         int titleX = x + (w - titleLen) / 2; 
-        mvprintw(y, titleX - 1, " "); 
-        mvprintw(y, titleX, "%s", title);
-        mvprintw(y, titleX + titleLen, " "); 
+        mvwprintw(win, y, titleX - 1, " "); 
+        mvwprintw(win, y, titleX, "%s", title);
+        mvwprintw(win, y, titleX + titleLen, " "); 
     }
     
-    attroff(COLOR_PAIR(3));
+    wattroff(win, COLOR_PAIR(3));
 }
 
-void printCentered(int y, std::string text, bool highlight = false) {
-    int midX = COLS / 2;
+void printCentered(WINDOW* win, int y, std::string text, bool highlight = false) {
+    int midX = getmaxx(win) / 2;
     int startX = midX - (text.length() / 2);
     
-    if (highlight) attron(A_REVERSE);
-    mvprintw(y, startX, "%s", text.c_str());
-    if (highlight) attroff(A_REVERSE);
+    if (highlight) wattron(win, A_REVERSE);
+    mvwprintw(win, y, startX, "%s", text.c_str());
+    if (highlight) wattroff(win, A_REVERSE);
 }
 
-void draw() {
-    clear();
-    int offsetX = (COLS - config.width) / 2;
-    int offsetY = (LINES - config.height) / 2;
+// Boards bigger than the terminal are seen through a camera window that
+// follows the head. It re-centres once the head comes within a quarter
+// window of an edge, so most ticks do not scroll. Only cells inside the
+// window are ever painted, whatever the board size.
+struct Camera {
+    int x = 0, y = 0;  // board cell shown at the window's top-left
+    int w = 0, h = 0;
+    int screenX = 0, screenY = 0;
+    int boardW = 0, boardH = 0;
+
+    // Leaves two rows under the window for the HUD.
+    void fit(WINDOW* win, int width, int height) {
+        int lines = getmaxy(win), cols = getmaxx(win);
+        boardW = width;
+        boardH = height;
+        w = std::min(width, cols);
+        h = std::min(height, std::max(1, lines - 4));
+        screenX = (cols - w) / 2;
+        screenY = std::max(0, std::min((lines - h) / 2, lines - h - 3));
+        x = std::max(0, std::min(x, boardW - w));
+        y = std::max(0, std::min(y, boardH - h));
+    }
 
-    drawBox(offsetY, offsetX, config.height, config.width);
+    bool scrolls() const { return w < boardW || h < boardH; }
+
+    // True when the window moved.
+    bool follow(Point head) {
+        int nx = x, ny = y;
+        if (head.x < x + w / 4 || head.x >= x + w - w / 4) nx = head.x - w / 2;
+        if (head.y < y + h / 4 || head.y >= y + h - h / 4) ny = head.y - h / 2;
+        nx = std::max(0, std::min(nx, boardW - w));
+        ny = std::max(0, std::min(ny, boardH - h));
+        bool moved = nx != x || ny != y;
+        x = nx;
+        y = ny;
+        return moved;
+    }
+
+    bool visible(int bx, int by) const {
+        return bx >= x && bx < x + w && by >= y && by < y + h;
+    }
+};
+
+// The board's outer ring, drawn cell by cell so that a scrolled window shows
+// whichever stretch of it is in view.
+const char* borderGlyph(int x, int y, int width, int height) {
+    bool left = x == 0, right = x == width - 1, top = y == 0, bottom = y == height - 1;
+    if (top) return left ? "┌" : right ? "┐" : "─";
+    if (bottom) return left ? "└" : right ? "┘" : "─";
+    if (left || right) return "│";
+    return nullptr;
+}
+
+void drawBorderCell(WINDOW* win, const Camera& cam, int x, int y) {
+    wattron(win, COLOR_PAIR(3));
+    mvwprintw(win, cam.screenY + y - cam.y, cam.screenX + x - cam.x, "%s", borderGlyph(x, y, cam.boardW, cam.boardH));
+    wattroff(win, COLOR_PAIR(3));
+}
+
+// The frame, the labels and the visible board are painted once per game,
+// after a terminal resize, and whenever the camera scrolls. Every other
+// tick repaints only the cells the simulation touched (new head, old head,
+// vacated tail, respawned food) and the HUD numbers that changed, so the
+// output per tick does not grow with the snake.
+bool fullRedraw = true;
+int shownScore = -1, shownHigh = -1;
+int shownLines = 0, shownCols = 0;
+Camera camera;
+
+// On scrolling boards a minimap in the top-right corner shows the whole
+// board. It reads the simulation's downsampled occupancy grid (body
+// segments per 2^shift square), so it costs the same on any board size, and
+// it is repainted only when a square fills or empties, food respawns, the
+// head crosses into another square or the camera moves.
+const int MINIMAP_WIDTH = 32, MINIMAP_HEIGHT = 16;
+int minimapX = 0, minimapY = 0, minimapW = 0, minimapH = 0;
+int shownHeadSquare = -1;
+
+int minimapShift(int width, int height) {
+    int shift = 0;
+    while (((width - 1) >> shift) + 1 > MINIMAP_WIDTH || ((height - 1) >> shift) + 1 > MINIMAP_HEIGHT) shift++;
+    return shift;
+}
+
+bool underMinimap(int sy, int sx) {
+    return minimapW > 0 && sy >= minimapY && sy < minimapY + minimapH + 2 && sx >= minimapX && sx < minimapX + minimapW + 2;
+}
+
+void drawMinimap(WINDOW* win) {
+    int shift = game.coarseShift;
+    drawBox(win, minimapY, minimapX, minimapH + 2, minimapW + 2);
+    int headSquare = ((game.snake.front().y >> shift) * game.coarseWidth) + (game.snake.front().x >> shift);
+    for (int cy = 0; cy < minimapH; cy++)
+        for (int cx = 0; cx < minimapW; cx++) {
+            int square = cy * game.coarseWidth + cx;
+            bool inView = (cx << shift) < camera.x + camera.w && ((cx + 1) << shift) > camera.x &&
+                          (cy << shift) < camera.y + camera.h && ((cy + 1) << shift) > camera.y;
+            if (inView) wattron(win, A_REVERSE);
+            if (square == headSquare) {
+                wattron(win, COLOR_PAIR(config.godMode ? 4 : 1));
+                mvwprintw(win, minimapY + 1 + cy, minimapX + 1 + cx, "▓");
+                wattroff(win, COLOR_PAIR(config.godMode ? 4 : 1));
+            } else if (game.coarse[square] > 0) {
+                wattron(win, COLOR_PAIR(1));
+                mvwprintw(win, minimapY + 1 + cy, minimapX + 1 + cx, "▒");
+                wattroff(win, COLOR_PAIR(1));
+            } else {
+                mvwaddch(win, minimapY + 1 + cy, minimapX + 1 + cx, ' ');
+            }
+            if (inView) wattroff(win, A_REVERSE);
+        }
+    wattron(win, COLOR_PAIR(2));
+    for (auto& f : game.fruits)
+        mvwprintw(win, minimapY + 1 + (f.y >> shift), minimapX + 1 + (f.x >> shift), "*");
+    wattroff(win, COLOR_PAIR(2));
+    shownHeadSquare = headSquare;
+    game.coarseChanged = false;
+}
+
+void drawBoardCell(WINDOW* win, int cell) {
+    int x = cell % game.width, y = cell / game.width;
+    if (!camera.visible(x, y)) return;
+    int sy = camera.screenY + y - camera.y, sx = camera.screenX + x - camera.x;
+    if (underMinimap(sy, sx)) return;
+    if (borderGlyph(x, y, game.width, game.height)) {
+        drawBorderCell(win, camera, x, y);
+    } else if (game.occupancy[cell] > 0) {
+        bool head = cell == game.cellIndex(game.snake.front());
+        int pair = head && config.godMode ? 4 : 1;
+        wattron(win, COLOR_PAIR(pair));
+        mvwprintw(win, sy, sx, head ? "▓" : "▒");
+        wattroff(win, COLOR_PAIR(pair));
+    } else if (game.foodAt[cell]) {
+        wattron(win, COLOR_PAIR(2));
+        mvwprintw(win, sy, sx, "*");
+        wattroff(win, COLOR_PAIR(2));
+    } else {
+        mvwaddch(win, sy, sx, ' ');
+    }
+}
+
+void draw(WINDOW* win) {
+    bool resized = getmaxy(win) != shownLines || getmaxx(win) != shownCols;
+    if (fullRedraw || resized) camera.fit(win, game.width, game.height);
+    bool scrolled = camera.follow(game.snake.front());
+    int offsetX = camera.screenX;
+    int infoY = camera.screenY + camera.h + 1;
+
+    bool repaintMinimap = false;
+    if (fullRedraw || resized || scrolled) {
+        werase(win);
+        minimapW = minimapH = 0;
+        if (camera.scrolls()) {
+            minimapW = ((game.width - 1) >> game.coarseShift) + 1;
+            minimapH = ((game.height - 1) >> game.coarseShift) + 1;
+            minimapX = getmaxx(win) - minimapW - 2;
+            minimapY = 0;
+        }
+        for (int y = camera.y; y < camera.y + camera.h; y++)
+            for (int x = camera.x; x < camera.x + camera.w; x++) drawBoardCell(win, y * game.width + x);
+
+        if (config.godMode) {
+            wattron(win, COLOR_PAIR(4));
+            mvwprintw(win, infoY, offsetX + 30, "[GOD MODE]");
+            wattroff(win, COLOR_PAIR(4));
+        }
+        if (config.pilot != PILOT_OFF) {
+            wattron(win, COLOR_PAIR(3));
+            if (config.pilot == PILOT_CYCLE)
+                mvwprintw(win, infoY + 1, offsetX, autopilotReady ? "[AUTOPILOT]" : "[AUTOPILOT: no cycle fits this board]");
+            else
+                mvwprintw(win, infoY + 1, offsetX, !aiPolicy.empty() ? "[AI]" : "[AI: no snake.policy, see snake --train]");
+            wattroff(win, COLOR_PAIR(3));
+        }
+        fullRedraw = false;
+        shownLines = getmaxy(win);
+        shownCols = getmaxx(win);
+        shownScore = shownHigh = -1;
+        repaintMinimap = true;
+    } else {
+        for (int cell : game.touched) drawBoardCell(win, cell);
+    }
+    game.touched.clear();
+
+    if (minimapW > 0) {
+        int shift = game.coarseShift;
+        int headSquare = ((game.snake.front().y >> shift) * game.coarseWidth) + (game.snake.front().x >> shift);
+        if (repaintMinimap || game.coarseChanged || headSquare != shownHeadSquare || game.score != shownScore)
+            drawMinimap(win);
+    }
+
+    if (game.score != shownScore) {
+        mvwprintw(win, infoY, offsetX, "Score: %-7d", game.score);
+        shownScore = game.score;
+    }
+    if (highScore != shownHigh) {
+        mvwprintw(win, infoY, offsetX + 15, "High: %-7d", highScore);
+        shownHigh = highScore;
+    }
+}
+
+// Keys are taken as they arrive, not once per tick: the host hands each one
+// over while it waits for the next tick, so every key gets a timestamp. A
+// direction key is checked against the last *queued* direction, so
+// up-then-left within one tick becomes two turns on two ticks, while a
+// reversal or a repeat of that direction is dropped. Each tick applies the
+// oldest turn and records how long the key waited for its move.
+struct InputQueue {
+    struct Turn {
+        int dx, dy;
+        std::chrono::steady_clock::time_point at;
+    };
+    static const int CAPACITY = 3;
+    Turn turns[CAPACITY];
+    int first = 0, count = 0;
+
+    long long latencyTotalUs = 0, latencyMaxUs = 0;
+    int latencyCount = 0;
+
+    void reset() {
+        first = count = 0;
+        latencyTotalUs = latencyMaxUs = 0;
+        latencyCount = 0;
+    }
+
+    void push(int dx, int dy, int dirX, int dirY) {
+        if (count > 0) {
+            const Turn& last = turns[(first + count - 1) % CAPACITY];
+            dirX = last.dx;
+            dirY = last.dy;
+        }
+        if ((dx == dirX && dy == dirY) || (dx == -dirX && dy == -dirY) || count == CAPACITY) return;
+        turns[(first + count) % CAPACITY] = {dx, dy, std::chrono::steady_clock::now()};
+        count++;
+    }
+
+    void key(int ch, int dirX, int dirY) {
+        switch (ch) {
+            case KEY_LEFT: case 'a': push(-1, 0, dirX, dirY); break;
+            case KEY_RIGHT: case 'd': push(1, 0, dirX, dirY); break;
+            case KEY_UP: case 'w': push(0, -1, dirX, dirY); break;
+            case KEY_DOWN: case 's': push(0, 1, dirX, dirY); break;
+        }
+    }
+
+    void apply(int& dirX, int& dirY) {
+        if (count == 0) return;
+        const Turn& t = turns[first];
+        first = (first + 1) % CAPACITY;
+        count--;
+        dirX = t.dx;
+        dirY = t.dy;
+        long long us = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - t.at).count();
+        latencyTotalUs += us;
+        latencyMaxUs = std::max(latencyMaxUs, us);
+        latencyCount++;
+    }
+};
+
+InputQueue inputs;
+
+// Time between two ticks; vertical moves are slower to make up for
+// terminal cells being taller than they are wide.
+std::chrono::microseconds tickDelay(int dirY) {
+    return std::chrono::microseconds(dirY != 0 ? (long long)(config.speedDelay * 1.7) : config.speedDelay);
+}
+
+// Autopilot: the snake follows a Hamiltonian cycle of the interior. Reading
+// the body from tail to head, each segment sits further along the cycle than
+// the last, so the cells between the head and the tail (in cycle order) are
+// all free. Any move that lands in that stretch, at most as far as the tail
+// itself, keeps the property, and the plain cycle step is always one of
+// them; that is what makes the autopilot unable to die. Shortcuts are such
+// moves that skip ahead towards a fruit.
+std::vector<int> cycleOrder;  // board cell -> position on the cycle, -1 on walls
+std::vector<int> cycleCells;  // position on the cycle -> board cell
+int cycleLength = 0;
+
+const int AUTOPILOT_NODE_LIMIT = 4096;
+
+int cycleDist(int from, int to) {
+    int d = cycleOrder[to] - cycleOrder[from];
+    return d < 0 ? d + cycleLength : d;
+}
+
+// Zigzags through rows 1.. (or columns 1.. when transposed) and returns up the
+// first column (row), which needs an even number of rows (columns).
+bool buildCycle(const SnakeSim& s, bool transposed, bool reversed) {
+    int w = s.width - 2, h = s.height - 2;
+    if (transposed) std::swap(w, h);
+    if (h % 2 != 0 || w < 2) return false;
+
+    std::vector<Point> path;
+    for (int x = 0; x < w; x++) path.push_back({x, 0});
+    for (int y = 1; y < h; y++)
+        for (int k = 1; k < w; k++) path.push_back({y % 2 ? w - k : k, y});
+    for (int y = h - 1; y >= 1; y--) path.push_back({0, y});
+    if (reversed) std::reverse(path.begin() + 1, path.end());
+
+    cycleLength = path.size();
+    cycleOrder.assign(s.width * s.height, -1);
+    cycleCells.assign(cycleLength, 0);
+    for (int i = 0; i < cycleLength; i++) {
+        Point p = transposed ? Point{path[i].y + 1, path[i].x + 1} : Point{path[i].x + 1, path[i].y + 1};
+        cycleOrder[s.cellIndex(p)] = i;
+        cycleCells[i] = s.cellIndex(p);
+    }
+
+    // The starting body has to be in cycle order already.
+    int span = 0;
+    for (size_t i = s.snake.size() - 1; i > 0; i--) {
+        int step = cycleDist(s.cellIndex(s.snake[i]), s.cellIndex(s.snake[i - 1]));
+        if (step == 0) return false;
+        span += step;
+    }
+    return span < cycleLength;
+}
+
+void initAutopilot(const SnakeSim& s) {
+    autopilotReady = false;
+    for (int k = 0; k < 4 && !autopilotReady; k++) autopilotReady = buildCycle(s, k & 2, k & 1);
+}
+
+std::vector<int> searchStamp, searchCost, searchFrom;
+int searchRound = 0;
+
+// A* from the head to the target, only ever stepping further along the cycle
+// and never past the target, so every step of the path is a legal autopilot
+// move. Returns the first step, or -1 once the node budget runs out.
+int planShortcut(const SnakeSim& s, int head, int target) {
+    int cells = s.width * s.height;
+    if ((int)searchStamp.size() != cells) {
+        searchStamp.assign(cells, 0);
+        searchCost.assign(cells, 0);
+        searchFrom.assign(cells, 0);
+        searchRound = 0;
+    }
+    searchRound++;
+
+    int w = s.width, limit = cycleDist(head, target);
+    auto estimate = [&](int c) { return abs(c % w - target % w) + abs(c / w - target / w); };
+    std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int>>, std::greater<>> open;
+    searchStamp[head] = searchRound;
+    searchCost[head] = 0;
+    open.push({estimate(head), head});
+
+    const int offsets[4] = {1, -1, w, -w};
+    int expanded = 0;
+    while (!open.empty()) {
+        auto [f, c] = open.top();
+        open.pop();
+        if (f - estimate(c) > searchCost[c]) continue;
+        if (c == target) {
+            while (searchFrom[c] != head) c = searchFrom[c];
+            return c;
+        }
+        if (++expanded > AUTOPILOT_NODE_LIMIT) return -1;
+        int along = cycleDist(head, c);
+        for (int off : offsets) {
+            int n = c + off;
+            if (cycleOrder[n] < 0) continue;
+            int d = cycleDist(head, n);
+            if (d <= along || d > limit) continue;
+            int cost = searchCost[c] + 1;
+            if (searchStamp[n] == searchRound && searchCost[n] <= cost) continue;
+            searchStamp[n] = searchRound;
+            searchCost[n] = cost;
+            searchFrom[n] = c;
+            open.push({cost + estimate(n), n});
+        }
+    }
+    return -1;
+}
+
+// Picks this tick's direction: a shortcut towards the first fruit ahead on the
+// cycle, or the next cycle cell when every fruit is behind the head. Should
+// the search run out of budget, the neighbour furthest along the cycle
+// without overshooting the fruit is taken instead.
+void steerAutopilot(SnakeSim& s) {
+    if (!autopilotReady) return;
+    int head = s.cellIndex(s.snake.front());
+    int reach = cycleDist(head, s.cellIndex(s.snake.back()));
+
+    int target = -1, best = INT_MAX;
+    for (auto& f : s.fruits) {
+        int d = cycleDist(head, s.cellIndex(f));
+        if (d > 0 && d < reach && d < best) { best = d; target = s.cellIndex(f); }
+    }
 
-    attron(COLOR_PAIR(1)); 
-    for (size_t i = 0; i < snake.size(); i++) {
-        if (i == 0) {
-            if (config.godMode) attron(COLOR_PAIR(4)); 
-            mvprintw(offsetY + snake[i].y, offsetX + snake[i].x, "▓");
-            if (config.godMode) attroff(COLOR_PAIR(4));
+    int next = cycleCells[(cycleOrder[head] + 1) % cycleLength];
+    if (target >= 0) {
+        int step = planShortcut(s, head, target);
+        if (step >= 0) {
+            next = step;
         } else {
-            mvprintw(offsetY + snake[i].y, offsetX + snake[i].x, "▒");
+            const int offsets[4] = {1, -1, s.width, -s.width};
+            for (int off : offsets) {
+                int n = head + off;
+                if (cycleOrder[n] < 0) continue;
+                int d = cycleDist(head, n);
+                if (d <= best && d > cycleDist(head, next)) next = n;
+            }
+        }
+    }
+
+    int w = s.width;
+    s.dirX = next % w - head % w;
+    s.dirY = next / w - head / w;
+}
+
+// AI pilot: a small MLP evolved offline by `snake --train`. It sees the board
+// from the head's point of view and picks turn left, go straight or turn
+// right. For each of those three directions: whether the next cell is
+// blocked, how close the nearest obstacle is along that ray, and whether a
+// fruit lies on it; then where the nearest fruit is (ahead and to the right),
+// and how much of the board the body covers.
+const char* POLICY_FILE = "snake.policy";
+const int POLICY_INPUTS = 12;
+const int POLICY_HIDDEN = 16;
+const int POLICY_OUTPUTS = 3;
+const int POLICY_PARAMS = POLICY_HIDDEN * (POLICY_INPUTS + 1) + POLICY_OUTPUTS * (POLICY_HIDDEN + 1);
+
+void policyFeatures(const SnakeSim& s, float* out) {
+    Point head = s.snake.front();
+    const int dirs[3][2] = {{s.dirY, -s.dirX}, {s.dirX, s.dirY}, {-s.dirY, s.dirX}};
+    auto blocked = [&](int x, int y) {
+        return x <= 0 || x >= s.width - 1 || y <= 0 || y >= s.height - 1 || s.occupancy[y * s.width + x] > 0;
+    };
+    for (int d = 0; d < 3; d++) {
+        int x = head.x + dirs[d][0], y = head.y + dirs[d][1], steps = 1;
+        bool food = false;
+        while (!blocked(x, y)) {
+            food = food || s.foodAt[y * s.width + x];
+            x += dirs[d][0];
+            y += dirs[d][1];
+            steps++;
         }
+        out[d * 3] = steps == 1;
+        out[d * 3 + 1] = 1.0f / steps;
+        out[d * 3 + 2] = food;
     }
-    attroff(COLOR_PAIR(1));
 
-    attron(COLOR_PAIR(2)); 
-    for (auto& f : fruits) {
-        mvprintw(offsetY + f.y, offsetX + f.x, "*");
+    int fx = 0, fy = 0, nearest = INT_MAX;
+    for (auto& f : s.fruits) {
+        int d = abs(f.x - head.x) + abs(f.y - head.y);
+        if (d < nearest) { nearest = d; fx = f.x - head.x; fy = f.y - head.y; }
     }
-    attroff(COLOR_PAIR(2));
+    float scale = 1.0f / std::max(s.width, s.height);
+    out[9] = (fx * s.dirX + fy * s.dirY) * scale;
+    out[10] = (fx * -s.dirY + fy * s.dirX) * scale;
+    out[11] = (float)s.snake.size() / ((s.width - 2) * (s.height - 2));
+}
+
+// Evaluates a batch of feature rows against one genome. The weights are one
+// flat array (hidden rows of inputs + bias, then output rows of hidden +
+// bias), so a whole batch streams past rows that stay in L1 and every inner
+// loop is a contiguous dot product. `hidden` is the caller's scratch.
+void policyActions(const float* weights, const float* features, int batch, uint8_t* actions,
+                   std::vector<float>& hidden) {
+    hidden.resize((size_t)batch * POLICY_HIDDEN);
+
+    const float* w = weights;
+    for (int h = 0; h < POLICY_HIDDEN; h++, w += POLICY_INPUTS + 1)
+        for (int b = 0; b < batch; b++) {
+            const float* x = features + (size_t)b * POLICY_INPUTS;
+            float sum = w[POLICY_INPUTS];
+            for (int i = 0; i < POLICY_INPUTS; i++) sum += w[i] * x[i];
+            hidden[(size_t)b * POLICY_HIDDEN + h] = std::tanh(sum);
+        }
 
-    int infoY = offsetY + config.height + 1;
-    mvprintw(infoY, offsetX, "Score: %d", score);
-    mvprintw(infoY, offsetX + 15, "High: %d", highScore);
-    if (config.godMode) {
-        attron(COLOR_PAIR(4));
-        mvprintw(infoY, offsetX + 30, "[GOD MODE]");
-        attroff(COLOR_PAIR(4));
+    for (int b = 0; b < batch; b++) {
+        const float* x = hidden.data() + (size_t)b * POLICY_HIDDEN;
+        const float* o = w;
+        float best = -INFINITY;
+        for (int k = 0; k < POLICY_OUTPUTS; k++, o += POLICY_HIDDEN + 1) {
+            float sum = o[POLICY_HIDDEN];
+            for (int i = 0; i < POLICY_HIDDEN; i++) sum += o[i] * x[i];
+            if (sum > best) { best = sum; actions[b] = k; }
+        }
     }
+}
+
+// 0 turns left, 1 keeps going, 2 turns right.
+void applyPolicyAction(SnakeSim& s, int action) {
+    int dx = s.dirX, dy = s.dirY;
+    if (action == 0) { s.dirX = dy; s.dirY = -dx; }
+    else if (action == 2) { s.dirX = -dy; s.dirY = dx; }
+}
+
+void steerPolicy(SnakeSim& s) {
+    if (aiPolicy.empty()) return;
+    float features[POLICY_INPUTS];
+    uint8_t action;
+    policyFeatures(s, features);
+    policyActions(aiPolicy.data(), features, 1, &action, aiHidden);
+    applyPolicyAction(s, action);
+}
+
+// Policy files are the trainer's checkpoints: a header, then every genome of
+// the last generation, best first. The game only reads the first one.
+struct PolicyHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t inputs, hidden, outputs;
+    uint32_t generation;
+    uint32_t count;
+};
+
+const char POLICY_MAGIC[8] = {'S', 'N', 'K', 'P', 'O', 'L', 'C', 'Y'};
 
-    refresh();
+bool loadPolicies(const char* path, std::vector<std::vector<float>>& genomes, uint32_t& generation, size_t limit = SIZE_MAX) {
+    std::ifstream in(path, std::ios::binary);
+    PolicyHeader header;
+    if (!in.read((char*)&header, sizeof(header))) return false;
+    if (memcmp(header.magic, POLICY_MAGIC, sizeof(POLICY_MAGIC)) != 0 || header.version != 1 ||
+        header.inputs != POLICY_INPUTS || header.hidden != POLICY_HIDDEN || header.outputs != POLICY_OUTPUTS)
+        return false;
+    genomes.assign(std::min<size_t>(header.count, limit), std::vector<float>(POLICY_PARAMS));
+    for (auto& g : genomes)
+        if (!in.read((char*)g.data(), POLICY_PARAMS * sizeof(float))) return false;
+    generation = header.generation;
+    return !genomes.empty();
 }
 
-void input() {
-    int ch = getch();
-    switch (ch) {
-        case KEY_LEFT: case 'a': if (dirX != 1) { dirX = -1; dirY = 0; } break;
-        case KEY_RIGHT: case 'd': if (dirX != -1) { dirX = 1; dirY = 0; } break;
-        case KEY_UP: case 'w': if (dirY != 1) { dirX = 0; dirY = -1; } break;
-        case KEY_DOWN: case 's': if (dirY != -1) { dirX = 0; dirY = 1; } break;
-        case 'q': gameOver = true; break;
+bool savePolicies(const char* path, const std::vector<std::vector<float>>& genomes, uint32_t generation) {
+    PolicyHeader header;
+    memcpy(header.magic, POLICY_MAGIC, sizeof(POLICY_MAGIC));
+    header.version = 1;
+    header.inputs = POLICY_INPUTS;
+    header.hidden = POLICY_HIDDEN;
+    header.outputs = POLICY_OUTPUTS;
+    header.generation = generation;
+    header.count = genomes.size();
+
+    // Written aside and renamed, so a game starting mid-save never sees half a file.
+    std::string tmp = std::string(path) + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary);
+        if (!out.is_open()) return false;
+        out.write((const char*)&header, sizeof(header));
+        for (auto& g : genomes) out.write((const char*)g.data(), POLICY_PARAMS * sizeof(float));
+        if (!out) return false;
     }
+    return rename(tmp.c_str(), path) == 0;
 }
 
-void logic() {
-    Point newHead = {snake[0].x + dirX, snake[0].y + dirY};
+void loadAiPolicy() {
+    std::vector<std::vector<float>> genomes;
+    uint32_t generation;
+    if (loadPolicies(POLICY_FILE, genomes, generation, 1)) aiPolicy = genomes[0];
+}
 
-    if (config.godMode) {
-        if (newHead.x >= config.width - 1) newHead.x = 1;
-        else if (newHead.x <= 0) newHead.x = config.width - 2;
-        if (newHead.y >= config.height - 1) newHead.y = 1;
-        else if (newHead.y <= 0) newHead.y = config.height - 2;
-    } else {
-        if (newHead.x <= 0 || newHead.x >= config.width - 1 || 
-            newHead.y <= 0 || newHead.y >= config.height - 1) {
-            gameOver = true;
+// Arena: the player (snake 0) against AI snakes on one board. Every body
+// lives in a single occupancy grid holding its snake's id, so collision and
+// food checks are one lookup per snake however many there are. Each tick one
+// BFS from all the fruits builds a shared distance field; the AI snakes
+// choose their moves from it in parallel, and then all moves resolve at
+// once. Dead AI snakes come back after a short while.
+const int ARENA_RESPAWN_TICKS = 30;
+
+// Arena::room()'s flood fill buffers; one per pool worker.
+struct RoomScratch {
+    std::vector<int> stamp, queue;
+    int round = 0;
+};
+
+struct ArenaSnake {
+    SnakeBody body;
+    int dirX = 1, dirY = 0;
+    int score = 0;
+    bool alive = false;
+    int respawnIn = 0;
+};
+
+struct Arena {
+    int width = 0, height = 0;
+    std::vector<ArenaSnake> snakes;
+    std::vector<uint16_t> occupant;  // snake id + 1, 0 when empty
+    std::vector<int> fruitAt;        // index into fruits, -1 when no food
+    std::vector<Point> fruits;
+    FreeCellIndex freeCells;
+    std::vector<int> distance;       // moves to the nearest fruit, INT_MAX if cut off
+    std::vector<int> targets;
+    std::vector<uint8_t> claims;
+    std::vector<int> frontier;       // buildDistanceField()'s queue
+    std::vector<RoomScratch> scratch;
+    std::minstd_rand rng;
+    std::unique_ptr<WorkerPool> pool;
+    double tickUs = 0;
+
+    int cellIndex(Point p) const { return p.y * width + p.x; }
+
+    bool inside(int cell) const {
+        int x = cell % width, y = cell / width;
+        return x > 0 && x < width - 1 && y > 0 && y < height - 1;
+    }
+
+    void occupy(int id, Point p) {
+        snakes[id].body.pushFront(p);
+        occupant[cellIndex(p)] = id + 1;
+        freeCells.take(cellIndex(p));
+    }
+
+    void vacate(Point p) {
+        occupant[cellIndex(p)] = 0;
+        freeCells.release(cellIndex(p));
+    }
+
+    void spawnFruit(int k) {
+        if (freeCells.empty()) {
+            fruits[k] = {-1, -1};
             return;
         }
+        int cell = freeCells.pick(rng);
+        fruits[k] = {cell % width, cell / width};
+        fruitAt[cell] = k;
+        freeCells.take(cell);
     }
 
-    if (!config.godMode) {
-        for (size_t i = 0; i < snake.size(); i++) {
-            if (snake[i].x == newHead.x && snake[i].y == newHead.y) {
-                gameOver = true;
-                return;
+    // A straight three-cell body heading right, dropped on a random free row
+    // segment; gives up after a few misses on a crowded board.
+    bool spawnSnake(int id) {
+        for (int attempt = 0; attempt < 32 && !freeCells.empty(); attempt++) {
+            int cell = freeCells.pick(rng);
+            Point p = {cell % width, cell / width};
+            if (p.x < 3 || p.x > width - 6) continue;
+            bool clear = true;
+            for (int dx = -2; dx <= 2 && clear; dx++) clear = freeCells.slot[cell + dx] >= 0;
+            if (!clear) continue;
+
+            ArenaSnake& s = snakes[id];
+            s.body.reset(64);
+            s.dirX = 1; s.dirY = 0;
+            s.alive = true;
+            for (int dx = -2; dx <= 0; dx++) occupy(id, {p.x + dx, p.y});
+            return true;
+        }
+        return false;
+    }
+
+    void reset(const GameConfig& cfg, int opponents, uint32_t seed) {
+        width = cfg.width;
+        height = cfg.height;
+        rng.seed(seed);
+        int cells = width * height;
+        occupant.assign(cells, 0);
+        fruitAt.assign(cells, -1);
+        distance.assign(cells, INT_MAX);
+        claims.assign(cells, 0);
+        freeCells.reset(cells);
+        for (int y = 1; y < height - 1; y++)
+            for (int x = 1; x < width - 1; x++) freeCells.release(cellIndex({x, y}));
+
+        snakes.assign(opponents + 1, ArenaSnake());
+        targets.assign(snakes.size(), -1);
+        snakes[0].body.reset(64);
+        int startX = width / 2, startY = height / 2;
+        for (int dx = -2; dx <= 0; dx++) occupy(0, {startX + dx, startY});
+        snakes[0].alive = true;
+        for (int id = 1; id <= opponents; id++) spawnSnake(id);
+
+        fruits.assign(std::max(cfg.foodCount, opponents / 2), Point{-1, -1});
+        for (size_t k = 0; k < fruits.size(); k++) spawnFruit(k);
+
+        int threads = std::max(1u, std::thread::hardware_concurrency());
+        if (!pool) pool.reset(new WorkerPool(threads));
+        scratch.resize(pool->size());
+    }
+
+    // Multi-source BFS from every fruit; bodies block it, so the field routes
+    // around the snakes as they lie this tick.
+    void buildDistanceField() {
+        std::vector<int>& queue = frontier;
+        queue.clear();
+        std::fill(distance.begin(), distance.end(), INT_MAX);
+        for (auto& f : fruits) {
+            if (f.x < 0) continue;
+            distance[cellIndex(f)] = 0;
+            queue.push_back(cellIndex(f));
+        }
+        const int offsets[4] = {1, -1, width, -width};
+        for (size_t head = 0; head < queue.size(); head++) {
+            int c = queue[head];
+            for (int off : offsets) {
+                int n = c + off;
+                if (!inside(n) || occupant[n] || distance[n] != INT_MAX) continue;
+                distance[n] = distance[c] + 1;
+                queue.push_back(n);
             }
         }
     }
 
-    snake.insert(snake.begin(), newHead);
+    // Free cells reachable from `start`, counting up to `limit`: a move into a
+    // pocket smaller than the body is a slow death.
+    int room(int start, int limit, RoomScratch& sc) const {
+        std::vector<int>& stamp = sc.stamp;
+        std::vector<int>& queue = sc.queue;
+        int& round = sc.round;
+        if (stamp.size() != occupant.size()) { stamp.assign(occupant.size(), 0); round = 0; }
+        round++;
+        queue.assign(1, start);
+        stamp[start] = round;
+        const int offsets[4] = {1, -1, width, -width};
+        for (size_t head = 0; head < queue.size() && (int)queue.size() < limit; head++)
+            for (int off : offsets) {
+                int n = queue[head] + off;
+                if (!inside(n) || occupant[n] || stamp[n] == round) continue;
+                stamp[n] = round;
+                queue.push_back(n);
+            }
+        return queue.size();
+    }
 
-    bool ate = false;
-    for (size_t i = 0; i < fruits.size(); i++) {
-        if (newHead.x == fruits[i].x && newHead.y == fruits[i].y) {
-            score += 10;
-            ate = true;
-            fruits[i] = getRandomEmptyPosition();
-            break; 
+    // Downhill on the distance field among the moves with enough room; when
+    // every move is cramped, the roomiest one.
+    void decide(int id, int worker) {
+        ArenaSnake& s = snakes[id];
+        Point head = s.body.front();
+        const int dirs[3][2] = {{s.dirX, s.dirY}, {s.dirY, -s.dirX}, {-s.dirY, s.dirX}};
+        int need = s.body.size() + 2;
+        int bestDist = INT_MAX, bestRoom = -1, pick = 0;
+        bool safe = false;
+        for (int d = 0; d < 3; d++) {
+            int n = cellIndex({head.x + dirs[d][0], head.y + dirs[d][1]});
+            if (!inside(n) || occupant[n]) continue;
+            int space = room(n, need, scratch[worker]);
+            bool roomy = space >= need;
+            if (roomy && (!safe || distance[n] < bestDist)) {
+                safe = true;
+                bestDist = distance[n];
+                pick = d;
+            } else if (!safe && space > bestRoom) {
+                bestRoom = space;
+                pick = d;
+            }
         }
+        s.dirX = dirs[pick][0];
+        s.dirY = dirs[pick][1];
     }
 
-    if (!ate) snake.pop_back();
+    // Resolves every move at once: tails that are not growing leave first,
+    // then a head dies on a wall, on a body, or when two heads claim a cell.
+    void tick() {
+        auto start = std::chrono::steady_clock::now();
+        buildDistanceField();
+        std::function<void(int, int)> task = [&](int i, int worker) {
+            if (snakes[i + 1].alive) decide(i + 1, worker);
+        };
+        pool->run(snakes.size() - 1, task);
+
+        for (size_t id = 0; id < snakes.size(); id++) {
+            ArenaSnake& s = snakes[id];
+            targets[id] = -1;
+            if (!s.alive) continue;
+            Point head = s.body.front();
+            targets[id] = cellIndex({head.x + s.dirX, head.y + s.dirY});
+            if (fruitAt[targets[id]] < 0) {
+                vacate(s.body.back());
+                s.body.popBack();
+            }
+        }
+        for (size_t id = 0; id < snakes.size(); id++)
+            if (targets[id] >= 0 && claims[targets[id]] < 2) claims[targets[id]]++;
+
+        for (size_t id = 0; id < snakes.size(); id++) {
+            int t = targets[id];
+            if (t < 0) continue;
+            ArenaSnake& s = snakes[id];
+            if (!inside(t) || occupant[t] || claims[t] > 1) {
+                s.alive = false;
+                s.respawnIn = ARENA_RESPAWN_TICKS;
+                continue;
+            }
+            occupy(id, {t % width, t / width});
+        }
+        for (size_t id = 0; id < snakes.size(); id++) {
+            int t = targets[id];
+            if (t < 0) continue;
+            claims[t] = 0;
+            ArenaSnake& s = snakes[id];
+            if (!s.alive) {
+                while (s.body.size() > 0) {
+                    if (occupant[cellIndex(s.body.back())] == id + 1) vacate(s.body.back());
+                    s.body.popBack();
+                }
+            } else if (fruitAt[t] >= 0) {
+                s.score += 10;
+                int k = fruitAt[t];
+                fruitAt[t] = -1;
+                spawnFruit(k);
+            }
+        }
+        for (size_t id = 1; id < snakes.size(); id++)
+            if (!snakes[id].alive && --snakes[id].respawnIn <= 0) spawnSnake(id);
+        for (size_t k = 0; k < fruits.size(); k++)
+            if (fruits[k].x < 0) spawnFruit(k);
+
+        tickUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    int alive() const {
+        int n = 0;
+        for (auto& s : snakes) n += s.alive;
+        return n;
+    }
+
+    // Joins the pool's threads and frees the boards. Called before the
+    // plugin can be unloaded, so no thread is left in its code; reset()
+    // starts everything again.
+    void release() {
+        pool.reset();
+        *this = Arena();
+    }
+};
+
+Arena arena;
+
+Camera arenaCamera;
+
+// Paints only the camera window, straight from the shared grids.
+void drawArena(WINDOW* win, bool reset = false) {
+    werase(win);
+    if (reset || arenaCamera.boardW != arena.width || arenaCamera.boardH != arena.height) {
+        arenaCamera = Camera();
+    }
+    arenaCamera.fit(win, arena.width, arena.height);
+    if (arena.snakes[0].alive) arenaCamera.follow(arena.snakes[0].body.front());
+
+    const Camera& cam = arenaCamera;
+    for (int y = cam.y; y < cam.y + cam.h; y++)
+        for (int x = cam.x; x < cam.x + cam.w; x++) {
+            int cell = y * arena.width + x;
+            if (borderGlyph(x, y, arena.width, arena.height)) {
+                drawBorderCell(win, cam, x, y);
+                continue;
+            }
+            int sy = cam.screenY + y - cam.y, sx = cam.screenX + x - cam.x;
+            if (int id = arena.occupant[cell]) {
+                const ArenaSnake& s = arena.snakes[id - 1];
+                int pair = id == 1 ? 1 : 5;
+                wattron(win, COLOR_PAIR(pair));
+                mvwprintw(win, sy, sx, cell == arena.cellIndex(s.body.front()) ? "▓" : "▒");
+                wattroff(win, COLOR_PAIR(pair));
+            } else if (arena.fruitAt[cell] >= 0) {
+                wattron(win, COLOR_PAIR(2));
+                mvwprintw(win, sy, sx, "*");
+                wattroff(win, COLOR_PAIR(2));
+            }
+        }
+
+    int offsetX = cam.screenX;
+    int infoY = cam.screenY + cam.h + 1;
+    mvwprintw(win, infoY, offsetX, "Score: %d", arena.snakes[0].score);
+    mvwprintw(win, infoY, offsetX + 15, "High: %d", highScore);
+    mvwprintw(win, infoY + 1, offsetX, "Snakes: %d/%zu  Tick: %.0f us", arena.alive(), arena.snakes.size(), arena.tickUs);
 }
 
 void changeSetting(int option) {
     switch (option) {
         case 0: 
-            config.sizeIndex = (config.sizeIndex + 1) % 3;
+            config.sizeIndex = (config.sizeIndex + 1) % 5;
             if (config.sizeIndex == 0) { config.width = 20; config.height = 10; }
             else if (config.sizeIndex == 1) { config.width = 40; config.height = 20; }
-            else { config.width = 60; config.height = 30; }
+            else if (config.sizeIndex == 2) { config.width = 60; config.height = 30; }
+            else if (config.sizeIndex == 3) { config.width = 250; config.height = 250; }
+            else { config.width = 1000; config.height = 1000; }
             break;
         case 1: 
             config.speedIndex = (config.speedIndex + 1) % 4;
@@ -239,6 +1243,12 @@ void changeSetting(int option) {
         case 3: 
             config.godMode = !config.godMode;
             break;
+        case 4:
+            config.pilot = (config.pilot + 1) % PILOT_COUNT;
+            break;
+        case 5:
+            config.arenaIndex = (config.arenaIndex + 1) % ARENA_SIZE_COUNT;
+            break;
     }
 }
 
@@ -247,7 +1257,9 @@ std::string getSettingLabel(int option) {
     switch (option) {
         case 0: 
             return (config.sizeIndex == 0) ? "Map Size: [ SMALL ]" : 
-                   (config.sizeIndex == 1) ? "Map Size: [ NORMAL ]" : "Map Size: [ LARGE ]";
+                   (config.sizeIndex == 1) ? "Map Size: [ NORMAL ]" :
+                   (config.sizeIndex == 2) ? "Map Size: [ LARGE ]" :
+                   (config.sizeIndex == 3) ? "Map Size: [ HUGE ]" : "Map Size: [ 1000x1000 ]";
         case 1:
             return (config.speedIndex == 0) ? "Speed:    [ SLOW ]" :
                    (config.speedIndex == 1) ? "Speed:    [ NORMAL ]" :
@@ -258,125 +1270,418 @@ std::string getSettingLabel(int option) {
         case 3:
             return std::string("God Mode: [ ") + (config.godMode ? "ON" : "OFF") + " ]";
         case 4:
+            return (config.pilot == PILOT_OFF) ? "Autopilot: [ OFF ]" :
+                   (config.pilot == PILOT_CYCLE) ? "Autopilot: [ CYCLE ]" : "Autopilot: [ AI ]";
+        case 5:
+            if (config.arenaIndex == 0) return "Arena:    [ OFF ]";
+            snprintf(buffer, sizeof(buffer), "Arena:    [ %d AI ]", ARENA_SIZES[config.arenaIndex]);
+            return std::string(buffer);
+        case 6:
             return "Back";
         default: return "";
     }
 }
 
-void showSettings() {
-    int selected = 0;
-    while (true) {
-        clear();
-        int midY = LINES / 2;
-        int midX = COLS / 2;
-        
-        drawBox(midY - MENU_HEIGHT/2, midX - MENU_WIDTH/2, MENU_HEIGHT, MENU_WIDTH, "SETTINGS");
+// The game is a screen state machine driven by the host: the menus wait for
+// keys, a round moves one step per tick, and the end screen stays over the
+// last frame until ENTER.
+enum Screen { SCREEN_MENU, SCREEN_SETTINGS, SCREEN_PLAYING, SCREEN_OVER };
+Screen screen = SCREEN_MENU;
+int menuSelected = 0, settingsSelected = 0;
 
-        for (int i = 0; i < 5; i++) {
-            std::string label = getSettingLabel(i);
-            printCentered(midY - 4 + i * 2, label, (i == selected));
-        }
+bool arenaMode = false;
+bool arenaFresh = false;  // the next arena frame starts from a new camera
+bool won = false;
+const char* unsaved = nullptr;
 
-        int c = getch();
-        switch (c) {
-            case KEY_UP: case 'w': if (selected > 0) selected--; break;
-            case KEY_DOWN: case 's': if (selected < 4) selected++; break;
-            case 10: 
-                if (selected == 4) return; 
-                changeSetting(selected);
-                break;
-        }
+void drawSettings(WINDOW* win) {
+    werase(win);
+    int midY = getmaxy(win) / 2;
+    int midX = getmaxx(win) / 2;
+    
+    drawBox(win, midY - MENU_HEIGHT/2, midX - MENU_WIDTH/2, MENU_HEIGHT, MENU_WIDTH, "SETTINGS");
+
+    for (int i = 0; i < 7; i++) {
+        std::string label = getSettingLabel(i);
+        printCentered(win, midY - 6 + i * 2, label, (i == settingsSelected));
     }
 }
 
-void showMenu() {
-    int selected = 0;
+void drawMenu(WINDOW* win) {
     const char* options[3] = {"Start Game", "Settings", "Exit"};
     
-    while (true) {
-        clear();
-        int midY = LINES / 2;
-        int midX = COLS / 2;
+    werase(win);
+    int midY = getmaxy(win) / 2;
+    int midX = getmaxx(win) / 2;
+
+    drawBox(win, midY - MENU_HEIGHT/2, midX - MENU_WIDTH/2, MENU_HEIGHT, MENU_WIDTH);
+    printCentered(win, midY - 4, "=== SNAKE GAME ===");
+    
+    char scoreBuf[40];
+    snprintf(scoreBuf, sizeof(scoreBuf), "High Score: %d", highScore);
+    printCentered(win, midY - 2, scoreBuf);
 
-        drawBox(midY - MENU_HEIGHT/2, midX - MENU_WIDTH/2, MENU_HEIGHT, MENU_WIDTH);
-        printCentered(midY - 4, "=== SNAKE GAME ===");
-        
-        char scoreBuf[40];
-        snprintf(scoreBuf, sizeof(scoreBuf), "High Score: %d", highScore);
-        printCentered(midY - 2, scoreBuf);
+    for (int i = 0; i < 3; i++) {
+        printCentered(win, midY + 1 + i * 2, options[i], (i == menuSelected));
+    }
+}
 
-        for (int i = 0; i < 3; i++) {
-            printCentered(midY + 1 + i * 2, options[i], (i == selected));
-        }
+void drawGameOver(WINDOW* win) {
+    int midY = getmaxy(win) / 2;
 
-        int c = getch();
-        switch (c) {
-            case KEY_UP: case 'w': if (selected > 0) selected--; break;
-            case KEY_DOWN: case 's': if (selected < 2) selected++; break;
-            case 10: 
-                if (selected == 0) return; 
-                if (selected == 1) showSettings();
-                if (selected == 2) { endwin(); exit(0); }
-                break;
-        }
+    wattron(win, COLOR_PAIR(won ? 1 : 2));
+    printCentered(win, midY, won ? "YOU WIN! The board is full." : "GAME OVER!");
+    
+    if (unsaved) {
+        printCentered(win, midY + 1, unsaved);
+        printCentered(win, midY + 2, "Press ENTER for Menu");
+    } else {
+        printCentered(win, midY + 1, "Press ENTER for Menu");
+    }
+    if (inputs.latencyCount > 0) {
+        char latency[80];
+        snprintf(latency, sizeof(latency), "Key-to-move: avg %.0f ms, max %.0f ms over %d turns",
+                 inputs.latencyTotalUs / 1000.0 / inputs.latencyCount, inputs.latencyMaxUs / 1000.0,
+                 inputs.latencyCount);
+        printCentered(win, midY + 3, latency);
+    }
+    
+    wattroff(win, COLOR_PAIR(won ? 1 : 2));
+}
+
+void startRound() {
+    arenaMode = ARENA_SIZES[config.arenaIndex] > 0;
+    won = false;
+    unsaved = arenaMode ? "(Score not saved: Arena)" :
+              config.godMode ? "(Score not saved: God Mode active)" :
+              config.pilot != PILOT_OFF ? "(Score not saved: Autopilot active)" : nullptr;
+
+    inputs.reset();
+    if (arenaMode) {
+        arena.reset(config, ARENA_SIZES[config.arenaIndex], rand());
+        arenaFresh = true;
+    } else {
+        game.trackChanges = true;
+        game.coarseShift = minimapShift(config.width, config.height);
+        game.reset(config, rand());
+        fullRedraw = true;
+        if (config.pilot == PILOT_CYCLE) initAutopilot(game);
+        if (config.pilot == PILOT_AI) loadAiPolicy();
+    }
+    screen = SCREEN_PLAYING;
+}
+
+// On death, a full board or 'q'.
+void endRound() {
+    if (!arenaMode) {
+        won = game.victory;
+        saveHighScore(game.score);
     }
+    screen = SCREEN_OVER;
 }
 
-int main() {
-    setlocale(LC_ALL, ""); 
+void init() {
     srand(time(0));
     loadHighScore();
-
-    initscr();
-    cbreak();
-    noecho();
-    curs_set(0); 
-    keypad(stdscr, TRUE); 
+    screen = SCREEN_MENU;
+    menuSelected = 0;
+    fullRedraw = true;
 
     if (has_colors()) {
-        start_color();
         init_pair(1, COLOR_GREEN, COLOR_BLACK);  
         init_pair(2, COLOR_RED, COLOR_BLACK);    
         init_pair(3, COLOR_CYAN, COLOR_BLACK);   
         init_pair(4, COLOR_YELLOW, COLOR_BLACK); 
+        init_pair(5, COLOR_MAGENTA, COLOR_BLACK);
     }
+}
 
-    while (true) {
-        nodelay(stdscr, FALSE);
-        showMenu();
+bool handleKey(int ch) {
+    switch (screen) {
+        case SCREEN_MENU:
+            switch (ch) {
+                case KEY_UP: case 'w': if (menuSelected > 0) menuSelected--; break;
+                case KEY_DOWN: case 's': if (menuSelected < 2) menuSelected++; break;
+                case 10: 
+                    if (menuSelected == 0) startRound();
+                    if (menuSelected == 1) { settingsSelected = 0; screen = SCREEN_SETTINGS; }
+                    if (menuSelected == 2) return false;
+                    break;
+            }
+            break;
+        case SCREEN_SETTINGS:
+            switch (ch) {
+                case KEY_UP: case 'w': if (settingsSelected > 0) settingsSelected--; break;
+                case KEY_DOWN: case 's': if (settingsSelected < 6) settingsSelected++; break;
+                case 10: 
+                    if (settingsSelected == 6) screen = SCREEN_MENU;
+                    else changeSetting(settingsSelected);
+                    break;
+            }
+            break;
+        case SCREEN_PLAYING:
+            if (ch == 'q') endRound();
+            else if (arenaMode) inputs.key(ch, arena.snakes[0].dirX, arena.snakes[0].dirY);
+            else inputs.key(ch, game.dirX, game.dirY);
+            break;
+        case SCREEN_OVER:
+            if (ch == 10) {
+                menuSelected = 0;
+                screen = SCREEN_MENU;
+            }
+            break;
+    }
+    return true;
+}
 
-        initGame();
-        gameOver = false;
-        nodelay(stdscr, TRUE); 
+void tick() {
+    if (screen != SCREEN_PLAYING) return;
+    if (arenaMode) {
+        ArenaSnake& player = arena.snakes[0];
+        inputs.apply(player.dirX, player.dirY);
+        arena.tick();
+        if (!player.alive) endRound();
+    } else {
+        inputs.apply(game.dirX, game.dirY);
+        if (config.pilot == PILOT_CYCLE) steerAutopilot(game);
+        else if (config.pilot == PILOT_AI) steerPolicy(game);
+        game.step();
+        if (game.over) endRound();
+    }
+}
 
-        while (!gameOver) {
-            input();
-            logic();
-            draw();
-            
-            if (dirY != 0) usleep(config.speedDelay * 1.7);
-            else usleep(config.speedDelay);
-        }
+void render(WINDOW* win) {
+    if (screen == SCREEN_MENU) drawMenu(win);
+    else if (screen == SCREEN_SETTINGS) drawSettings(win);
+    else {
+        if (arenaMode) drawArena(win, arenaFresh);
+        else draw(win);
+        arenaFresh = false;
+        if (screen == SCREEN_OVER) drawGameOver(win);
+    }
+}
 
-        saveHighScore();
-        nodelay(stdscr, FALSE);
-        
-        attron(COLOR_PAIR(2));
-        printCentered(LINES / 2, "GAME OVER!");
-        
-        if (config.godMode) {
-            printCentered(LINES / 2 + 1, "(Score not saved: God Mode active)");
-            printCentered(LINES / 2 + 2, "Press ENTER for Menu");
-        } else {
-            printCentered(LINES / 2 + 1, "Press ENTER for Menu");
+// A round ticks at its speed setting, slower while the snake moves
+// vertically; the menus and the end screen need no ticks.
+int tickInterval() {
+    if (screen != SCREEN_PLAYING) return 0;
+    int dirY = arenaMode ? arena.snakes[0].dirY : game.dirY;
+    return std::chrono::duration_cast<std::chrono::milliseconds>(tickDelay(dirY)).count();
+}
+
+void teardown() {
+    if (screen == SCREEN_PLAYING && !arenaMode) saveHighScore(game.score);
+    arena.release();
+    arenaMode = false;
+}
+
+const GamePlugin plugin = {
+    GAME_PLUGIN_ABI_VERSION, "snake", 0, init, handleKey, tick, render, teardown, tickInterval,
+};
+
+extern "C" const GamePlugin* game_plugin() { return &plugin; }
+
+// Plays one genome's games in lockstep, so each tick's policy call is one
+// batch over every game still running. A game also ends once the snake goes
+// a whole board's worth of moves without eating, which stops policies that
+// only learned to circle. Fitness is fruits per game, with survival as a
+// tie-breaker.
+struct GenomeScore {
+    double fitness = 0;
+    double fruits = 0;
+    long long moves = 0;
+};
+
+// evaluateGenome()'s buffers, one per trainer worker.
+struct GenomeRun {
+    std::vector<SnakeSim> sims;
+    std::vector<int> live, hunger;
+    std::vector<float> features, hidden;
+    std::vector<uint8_t> actions;
+};
+
+GenomeScore evaluateGenome(const float* weights, const GameConfig& cfg, const std::vector<uint32_t>& seeds,
+                           GenomeRun& run) {
+    std::vector<SnakeSim>& sims = run.sims;
+    std::vector<int>& live = run.live;
+    std::vector<int>& hunger = run.hunger;
+    std::vector<float>& features = run.features;
+    std::vector<uint8_t>& actions = run.actions;
+    int games = seeds.size();
+    if ((int)sims.size() < games) sims.resize(games);
+    live.clear();
+    hunger.assign(games, 0);
+    for (int i = 0; i < games; i++) {
+        sims[i].reset(cfg, seeds[i]);
+        live.push_back(i);
+    }
+    features.resize((size_t)games * POLICY_INPUTS);
+    actions.resize(games);
+
+    GenomeScore result;
+    int starve = (cfg.width - 2) * (cfg.height - 2);
+    while (!live.empty()) {
+        int batch = live.size();
+        for (int k = 0; k < batch; k++) policyFeatures(sims[live[k]], features.data() + (size_t)k * POLICY_INPUTS);
+        policyActions(weights, features.data(), batch, actions.data(), run.hidden);
+
+        int kept = 0;
+        for (int k = 0; k < batch; k++) {
+            SnakeSim& s = sims[live[k]];
+            int before = s.score;
+            applyPolicyAction(s, actions[k]);
+            s.step();
+            result.moves++;
+            hunger[live[k]] = s.score > before ? 0 : hunger[live[k]] + 1;
+            if (hunger[live[k]] > starve) s.over = true;
+            if (s.over) result.fruits += s.score / 10;
+            else live[kept++] = live[k];
         }
-        
-        attroff(COLOR_PAIR(2));
-        refresh();
-        
-        while (getch() != 10);
+        live.resize(kept);
+    }
+    result.fruits /= games;
+    result.fitness = result.fruits + 1e-4 * result.moves / games;
+    return result;
+}
+
+// snake --train [generations=100] [population=256] [games=16] [threads=auto]
+// [seed=1] [file=snake.policy]: neuroevolution of the AI pilot on the NORMAL
+// board. Every genome of a generation plays the same seeded games; the best
+// tenth survives unchanged and the rest are tournament-picked parents'
+// uniform crossovers with Gaussian mutations. The whole population is
+// checkpointed to the policy file after every generation, and training
+// resumes from it when it already exists.
+int runTrainer(int generations, int population, int games, int threads, uint32_t seed, const char* path) {
+    GameConfig cfg;
+    std::mt19937 rng(seed);
+    std::normal_distribution<float> initial(0.0f, 0.5f), mutation(0.0f, 0.2f);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    std::vector<std::vector<float>> pop;
+    uint32_t firstGeneration = 0;
+    if (loadPolicies(path, pop, firstGeneration)) {
+        printf("resuming %s at generation %u\n", path, firstGeneration);
+        pop.resize(population, pop[0]);
+    } else {
+        pop.assign(population, std::vector<float>(POLICY_PARAMS));
+        for (auto& g : pop)
+            for (auto& w : g) w = initial(rng);
     }
 
-    endwin();
+    WorkerPool pool(threads);
+    std::vector<GenomeRun> runs(pool.size());
+    std::vector<GenomeScore> scores(population);
+    std::vector<int> order(population);
+    std::vector<uint32_t> seeds(games);
+    printf("population %d, %d games each, %d threads, %d params per genome\n", population, games, threads, POLICY_PARAMS);
+
+    for (uint32_t gen = firstGeneration; gen < firstGeneration + generations; gen++) {
+        for (int g = 0; g < games; g++) seeds[g] = (seed * 2654435761u) ^ (gen * 40503u) ^ (g * 97u + 1);
+
+        auto start = std::chrono::steady_clock::now();
+        std::function<void(int, int)> task = [&](int i, int worker) {
+            scores[i] = evaluateGenome(pop[i].data(), cfg, seeds, runs[worker]);
+        };
+        pool.run(population, task);
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        for (int i = 0; i < population; i++) order[i] = i;
+        std::sort(order.begin(), order.end(), [&](int a, int b) { return scores[a].fitness > scores[b].fitness; });
+        std::vector<std::vector<float>> ranked(population);
+        double meanFruits = 0;
+        long long moves = 0;
+        for (int i = 0; i < population; i++) {
+            ranked[i] = std::move(pop[order[i]]);
+            meanFruits += scores[i].fruits;
+            moves += scores[i].moves;
+        }
+        printf("gen %4u  best %6.2f fruits  mean %6.2f  %8.0f moves/s  %5.2f s\n", gen + 1,
+               scores[order[0]].fruits, meanFruits / population, moves / secs, secs);
+        fflush(stdout);
+        if (!savePolicies(path, ranked, gen + 1)) {
+            fprintf(stderr, "cannot write %s\n", path);
+            return 1;
+        }
+
+        int elites = std::max(1, population / 10);
+        auto tournament = [&] {
+            int best = rng() % population;
+            for (int k = 0; k < 2; k++) best = std::min(best, (int)(rng() % population));
+            return best;
+        };
+        pop.assign(ranked.begin(), ranked.begin() + elites);
+        while ((int)pop.size() < population) {
+            const auto& a = ranked[tournament()];
+            const auto& b = ranked[tournament()];
+            std::vector<float> child(POLICY_PARAMS);
+            for (int k = 0; k < POLICY_PARAMS; k++) {
+                child[k] = (rng() & 1) ? a[k] : b[k];
+                if (unit(rng) < 0.1f) child[k] += mutation(rng);
+            }
+            pop.push_back(std::move(child));
+        }
+    }
     return 0;
 }
+
+// snake --bench [games=3] [width=60] [height=30] [food=1]: lets the autopilot
+// play until the board is full and reports moves per fruit, the time to fill
+// the board and the slowest planning step.
+int runBenchmark(int games, int width, int height, int food) {
+    config.width = width;
+    config.height = height;
+    config.foodCount = food;
+    config.pilot = PILOT_CYCLE;
+
+    long long totalMoves = 0, totalFruits = 0;
+    double totalMs = 0, worstUs = 0;
+    int deaths = 0;
+    for (int round = 0; round < games; round++) {
+        game.reset(config, 12345 + round);
+        initAutopilot(game);
+        if (!autopilotReady) {
+            fprintf(stderr, "no Hamiltonian cycle fits a %dx%d board\n", width, height);
+            return 1;
+        }
+        long long moves = 0, cap = 4LL * cycleLength * cycleLength;
+        auto start = std::chrono::steady_clock::now();
+        while (!game.over && moves < cap) {
+            auto planStart = std::chrono::steady_clock::now();
+            steerAutopilot(game);
+            worstUs = std::max(worstUs, std::chrono::duration<double, std::micro>(
+                std::chrono::steady_clock::now() - planStart).count());
+            game.step();
+            moves++;
+        }
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        int fruits = game.score / 10;
+        if (!game.victory) deaths++;
+        printf("game %d: %s after %lld moves, %d fruits, %.1f moves/fruit, %.1f ms\n", round + 1,
+               game.victory ? "board full" : "stopped", moves, fruits, (double)moves / std::max(1, fruits), ms);
+        totalMoves += moves;
+        totalFruits += fruits;
+        totalMs += ms;
+    }
+    printf("%dx%d board, %d games\n", width, height, games);
+    printf("  moves per fruit  %10.1f\n", (double)totalMoves / std::max(1LL, totalFruits));
+    printf("  moves to fill    %10.0f\n", (double)totalMoves / games);
+    printf("  ms to fill       %10.1f\n", totalMs / games);
+    printf("  worst plan us    %10.1f\n", worstUs);
+    printf("  unfinished       %10d\n", deaths);
+    return deaths ? 1 : 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string(argv[1]) == "--bench")
+        return runBenchmark(argc > 2 ? std::max(1, atoi(argv[2])) : 3, argc > 3 ? std::max(4, atoi(argv[3])) : 60,
+                            argc > 4 ? std::max(4, atoi(argv[4])) : 30, argc > 5 ? std::max(1, atoi(argv[5])) : 1);
+    if (argc > 1 && std::string(argv[1]) == "--train") {
+        int threads = argc > 5 ? atoi(argv[5]) : (int)std::max(1u, std::thread::hardware_concurrency());
+        return runTrainer(argc > 2 ? std::max(1, atoi(argv[2])) : 100, argc > 3 ? std::max(2, atoi(argv[3])) : 256,
+                          argc > 4 ? std::max(1, atoi(argv[4])) : 16, std::max(1, threads),
+                          argc > 6 ? (uint32_t)strtoul(argv[6], nullptr, 10) : 1, argc > 7 ? argv[7] : POLICY_FILE);
+    }
+
+    setlocale(LC_ALL, "");
+    return runGamePlugin(&plugin);
+}
@@ -4,391 +4,2812 @@
 #include <ctime>
 #include <clocale>
 #include <algorithm>
+#include <numeric>
+#include <cstring>
 #include <string>
 #include <random>
+#include <cstdint>
+#include <array>
+#include <atomic>
+#include <type_traits>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <deque>
+#include <map>
+#include <iostream>
+#include <fstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "game_plugin.h"
+#include "worker_pool.h"
 
 const int N = 9;
+const int MAX_N = 25;
 
 struct Cell {
     int val = 0;       
     bool fixed = false; 
-    bool isPencil = false;
+    uint32_t notes = 0;  // pencil marks, one bit per digit
 };
 
-Cell grid[N][N];     
-int solution[N][N];  
+Cell grid[MAX_N][MAX_N];     
+int solution[MAX_N][MAX_N];  
+int boxSize = 3;
+int gridSize = N;
 int cursorX = 0, cursorY = 0;
+int viewRow = 0, viewCol = 0;
 bool gameOver = false;
-int difficulty = 40; 
+int difficulty = 50; 
 
-time_t startTime;
+// The menu, a round, and the VICTORY / GAME OVER banner over the last grid.
+enum Screen { SCREEN_MENU, SCREEN_PLAYING, SCREEN_OVER };
+Screen screen = SCREEN_MENU;
+int menuSelected = 0;
+bool won = false;
+
+std::chrono::steady_clock::time_point startTime, endTime;
 int mistakes = 0;
 const int MAX_MISTAKES = 3;
 int hints = 3;
 bool pencilMode = false;
+double generationMs = 0;
+std::string hintMessage;
+
+// Geometry for a grid of B x B boxes (side S = B * B). Cell -> unit lookup,
+// the 3 * S units (rows, columns, boxes) as cell lists, and each cell's peers.
+// Masks hold one bit per digit, so 9x9 and 16x16 fit 16 bits and 25x25 needs 32.
+template <int B>
+struct GridTables {
+    static constexpr int S = B * B;
+    static constexpr int CELLS = S * S;
+    static constexpr int PEERS = 2 * (S - 1) + (B - 1) * (B - 1);
+    using Mask = typename std::conditional<(S <= 16), uint16_t, uint32_t>::type;
+    static constexpr Mask ALL = (Mask)((1ull << S) - 1);
+
+    int rowOf[CELLS], colOf[CELLS], boxOf[CELLS];
+    int units[3 * S][S];
+    int peers[CELLS][PEERS];
+
+    GridTables() {
+        for (int i = 0; i < CELLS; i++) {
+            int r = i / S, c = i % S;
+            rowOf[i] = r;
+            colOf[i] = c;
+            boxOf[i] = (r / B) * B + c / B;
+            units[r][c] = i;
+            units[S + c][r] = i;
+            units[2 * S + boxOf[i]][(r % B) * B + c % B] = i;
+        }
+        for (int i = 0; i < CELLS; i++) {
+            int count = 0;
+            for (int j = 0; j < CELLS; j++)
+                if (j != i && (rowOf[i] == rowOf[j] || colOf[i] == colOf[j] || boxOf[i] == boxOf[j]))
+                    peers[i][count++] = j;
+        }
+    }
+
+    bool sees(int a, int b) const {
+        return a != b && (rowOf[a] == rowOf[b] || colOf[a] == colOf[b] || boxOf[a] == boxOf[b]);
+    }
+
+    static const GridTables& get() {
+        static const GridTables instance;
+        return instance;
+    }
+};
+
+using SudokuTables = GridTables<3>;
+const SudokuTables& tables = SudokuTables::get();
+
+// Constraint-propagating solver. Each row/column/box keeps a mask of digits
+// already used, so a cell's candidates are one OR and one NOT away.
+// Placements are pushed on a trail and undone on backtrack instead of
+// copying the grid. Grids are flat, row-major arrays of S * S digits.
+template <int B>
+struct BasicSudokuSolver {
+    using Tables = GridTables<B>;
+    using Mask = typename Tables::Mask;
+    static constexpr int S = Tables::S;
+    static constexpr int CELLS = Tables::CELLS;
+    static constexpr Mask ALL = Tables::ALL;
+
+    const Tables& t = Tables::get();
+    int cells[CELLS];
+    Mask rowUsed[S], colUsed[S], boxUsed[S];
+    int trail[CELLS];
+    int trailLen;
+    int found;
+    int limit;
+    long long nodes;
+    long long nodeLimit = -1;
+    bool aborted;
+    int firstSolution[CELLS];
+
+    Mask candidates(int i) const {
+        return ALL & ~(rowUsed[t.rowOf[i]] | colUsed[t.colOf[i]] | boxUsed[t.boxOf[i]]);
+    }
+
+    void place(int i, int d) {
+        Mask bit = (Mask)1 << (d - 1);
+        cells[i] = d;
+        rowUsed[t.rowOf[i]] |= bit;
+        colUsed[t.colOf[i]] |= bit;
+        boxUsed[t.boxOf[i]] |= bit;
+        trail[trailLen++] = i;
+    }
+
+    void undoTo(int mark) {
+        while (trailLen > mark) {
+            int i = trail[--trailLen];
+            Mask bit = (Mask)1 << (cells[i] - 1);
+            rowUsed[t.rowOf[i]] &= ~bit;
+            colUsed[t.colOf[i]] &= ~bit;
+            boxUsed[t.boxOf[i]] &= ~bit;
+            cells[i] = 0;
+        }
+    }
+
+    bool load(const int* grid) {
+        for (int k = 0; k < S; k++) rowUsed[k] = colUsed[k] = boxUsed[k] = 0;
+        trailLen = 0;
+        for (int i = 0; i < CELLS; i++) {
+            cells[i] = 0;
+            int d = grid[i];
+            if (d == 0) continue;
+            if (d < 1 || d > S || !(candidates(i) & ((Mask)1 << (d - 1)))) return false;
+            place(i, d);
+        }
+        trailLen = 0;
+        return true;
+    }
+
+    Mask usedIn(int u) const {
+        return u < S ? rowUsed[u] : u < 2 * S ? colUsed[u - S] : boxUsed[u - 2 * S];
+    }
+
+    // Candidates of every cell in one branch-free sweep over the unit masks
+    // (filled cells get 0), laid out so the compiler can vectorize it.
+    void sweep(Mask* cand) const {
+        for (int r = 0; r < S; r++) {
+            const Mask* boxRow = &boxUsed[(r / B) * B];
+            for (int c = 0; c < S; c++) {
+                int i = r * S + c;
+                Mask empty = -(Mask)(cells[i] == 0);
+                cand[i] = ALL & ~(rowUsed[r] | colUsed[c] | boxRow[c / B]) & empty;
+            }
+        }
+    }
+
+    // Naked and hidden singles until nothing changes. False on contradiction.
+    // Both passes start from the last sweep; once something has been placed
+    // the cached masks are stale supersets, so they are re-checked against
+    // the live unit masks before use.
+    bool propagate() {
+        Mask cand[CELLS];
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            sweep(cand);
+            for (int i = 0; i < CELLS; i++) {
+                if (cells[i]) continue;
+                if (changed) cand[i] &= candidates(i);
+                if (!cand[i]) return false;
+                if (cand[i] & (cand[i] - 1)) continue;
+                place(i, __builtin_ctz(cand[i]) + 1);
+                cand[i] = 0;
+                changed = true;
+            }
+            for (int u = 0; u < 3 * S; u++) {
+                Mask once = 0, twice = 0, used = usedIn(u);
+                for (int k = 0; k < S; k++) {
+                    Mask c = cand[t.units[u][k]];
+                    twice |= once & c;
+                    once |= c;
+                }
+                if ((Mask)(once | used) != ALL) return false;
+                Mask hidden = once & ~twice & ~used;
+                while (hidden) {
+                    Mask bit = hidden & (Mask)(~hidden + 1);
+                    hidden &= hidden - 1;
+                    for (int k = 0; k < S; k++) {
+                        int i = t.units[u][k];
+                        if (!(cand[i] & bit)) continue;
+                        if (cells[i] || !(candidates(i) & bit)) return false;
+                        place(i, __builtin_ctz(bit) + 1);
+                        cand[i] = 0;
+                        changed = true;
+                        break;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    void search() {
+        if (nodeLimit >= 0 && ++nodes > nodeLimit) aborted = true;
+        if (aborted) return;
+
+        int mark = trailLen;
+        if (!propagate()) { undoTo(mark); return; }
+
+        int best = -1, bestCount = S + 1;
+        for (int i = 0; i < CELLS; i++) {
+            if (cells[i]) continue;
+            int count = __builtin_popcount(candidates(i));
+            if (count < bestCount) {
+                best = i;
+                bestCount = count;
+                if (count == 2) break;
+            }
+        }
+
+        if (best < 0) {
+            if (found++ == 0) std::copy(cells, cells + CELLS, firstSolution);
+            undoTo(mark);
+            return;
+        }
+
+        Mask cand = candidates(best);
+        while (cand && found < limit && !aborted) {
+            int d = __builtin_ctz(cand) + 1;
+            cand &= cand - 1;
+            int inner = trailLen;
+            place(best, d);
+            search();
+            undoTo(inner);
+        }
+        undoTo(mark);
+    }
+
+    // Counts solutions up to maxCount; the first one lands in firstSolution.
+    // With a node limit set, `aborted` tells whether the count is a lower bound.
+    int solve(const int* grid, int maxCount = 1) {
+        found = 0;
+        limit = maxCount;
+        nodes = 0;
+        aborted = false;
+        if (!load(grid)) return 0;
+        search();
+        return found;
+    }
+};
+
+using SudokuSolver = BasicSudokuSolver<3>;
+
+bool solveSudoku(int grid[N][N]) {
+    SudokuSolver solver;
+    if (solver.solve(&grid[0][0]) == 0) return false;
+    for (int i = 0; i < N * N; i++) grid[i / N][i % N] = solver.firstSolution[i];
+    return true;
+}
+
+// 1 only when the puzzle provably has a single solution. Giant grids pass a
+// node limit; running out of it counts as "not unique" so digging stays safe.
+template <int B>
+int countSolutionsOf(const int* grid, long long nodeLimit = -1) {
+    BasicSudokuSolver<B> solver;
+    solver.nodeLimit = nodeLimit;
+    int found = solver.solve(grid, 2);
+    return solver.aborted ? 2 : found;
+}
+
+int countSolutions(const int grid[N][N]) {
+    return countSolutionsOf<3>(&grid[0][0]);
+}
+
+// Threads a dig checks its candidate removals on.
+int digThreads() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Removes clues from a puzzle (a solved grid, or one dug before) while it
+// keeps a unique solution. Each round tests a batch of candidate removals in parallel against the
+// current puzzle. A removal that breaks uniqueness is dropped for good (taking
+// more clues away can only add solutions). The surviving removals are applied
+// together when the combined puzzle is still unique; otherwise only the first
+// is kept and the rest are retried next round. `isUnique(puzzle, worker)` is
+// called from the pool's digThreads() threads at once, each passing its own
+// worker index (0 for the calling thread); the same threads serve every
+// round of the dig.
+template <typename Unique>
+int digHolesWith(int* puzzle, int cells, int target, std::mt19937& g, Unique&& isUnique) {
+    std::vector<int> order;
+    for (int i = 0; i < cells; i++)
+        if (puzzle[i]) order.push_back(i);
+    std::shuffle(order.begin(), order.end(), g);
+
+    WorkerPool pool(digThreads());
+    std::vector<std::vector<int>> local(pool.size());
+    int batchSize = std::max(4, pool.size() * 2);
+    int holes = 0;
+    size_t next = 0;
+    std::vector<int> pending;
+
+    while (holes < target && (next < order.size() || !pending.empty())) {
+        while ((int)pending.size() < std::min(batchSize, target - holes) && next < order.size())
+            pending.push_back(order[next++]);
+
+        std::vector<char> keepsUnique(pending.size(), 0);
+        pool.run(pending.size(), [&](int k, int worker) {
+            std::vector<int>& trial = local[worker];
+            trial.assign(puzzle, puzzle + cells);
+            trial[pending[k]] = 0;
+            keepsUnique[k] = isUnique(trial.data(), worker);
+        });
+
+        std::vector<int> accepted;
+        for (size_t k = 0; k < pending.size(); k++)
+            if (keepsUnique[k]) accepted.push_back(pending[k]);
+        pending.clear();
+        if (accepted.empty()) continue;
+
+        std::vector<int> saved(accepted.size());
+        for (size_t k = 0; k < accepted.size(); k++) {
+            saved[k] = puzzle[accepted[k]];
+            puzzle[accepted[k]] = 0;
+        }
+        if (accepted.size() == 1 || isUnique(puzzle, 0)) {
+            holes += accepted.size();
+            continue;
+        }
+        for (size_t k = 1; k < accepted.size(); k++) {
+            puzzle[accepted[k]] = saved[k];
+            pending.push_back(accepted[k]);
+        }
+        holes++;
+    }
+    return holes;
+}
+
+template <int B>
+int digHolesOf(int* puzzle, int target, std::mt19937& g, long long nodeLimit = -1) {
+    return digHolesWith(puzzle, GridTables<B>::CELLS, target, g,
+                        [&](const int* p, int) { return countSolutionsOf<B>(p, nodeLimit) == 1; });
+}
+
+int digHoles(int puzzle[N][N], int target, std::mt19937& g) {
+    return digHolesOf<3>(&puzzle[0][0], target, g);
+}
+
+// Human-style techniques, cheapest first. A puzzle's grade is the grade of
+// the hardest technique needed to finish it without guessing.
+enum Technique {
+    T_NAKED_SINGLE, T_HIDDEN_SINGLE,
+    T_NAKED_PAIR, T_HIDDEN_PAIR, T_NAKED_TRIPLE, T_HIDDEN_TRIPLE,
+    T_POINTING, T_BOX_LINE,
+    T_XWING, T_SWORDFISH, T_XYWING, T_XYCHAIN,
+    T_COUNT
+};
+
+const char* TECHNIQUE_NAMES[T_COUNT] = {
+    "Naked single", "Hidden single",
+    "Naked pair", "Hidden pair", "Naked triple", "Hidden triple",
+    "Pointing", "Box/line reduction",
+    "X-Wing", "Swordfish", "XY-Wing", "XY-Chain"
+};
+
+enum Grade { GRADE_EASY, GRADE_NORMAL, GRADE_HARD, GRADE_EXPERT, GRADE_DIABOLICAL, GRADE_COUNT };
+const char* GRADE_NAMES[GRADE_COUNT] = { "Easy", "Normal", "Hard", "Expert", "Diabolical" };
+
+Grade gradeOf(Technique t) {
+    if (t <= T_HIDDEN_SINGLE) return GRADE_EASY;
+    if (t <= T_BOX_LINE) return GRADE_NORMAL;
+    if (t <= T_XYWING) return GRADE_HARD;
+    return GRADE_EXPERT;
+}
+
+std::string cellName(int i, int side = N) {
+    return "r" + std::to_string(i / side + 1) + "c" + std::to_string(i % side + 1);
+}
+
+// Digits past 9 are shown and typed as letters: 16x16 uses A-G, 25x25 A-P.
+char digitChar(int d) {
+    return d <= 9 ? '0' + d : 'A' + d - 10;
+}
+
+std::string unitName(int u) {
+    if (u < N) return "row " + std::to_string(u + 1);
+    if (u < 2 * N) return "column " + std::to_string(u - N + 1);
+    return "box " + std::to_string(u - 2 * N + 1);
+}
+
+std::string digitList(uint16_t mask) {
+    std::string out;
+    for (int d = 1; d <= N; d++) {
+        if (!(mask & (1 << (d - 1)))) continue;
+        if (!out.empty()) out += "/";
+        out += std::to_string(d);
+    }
+    return out;
+}
+
+struct LogicStep {
+    Technique tech;
+    int placeCell = -1;
+    int digit = 0;
+    uint16_t digits = 0;
+    int unit = -1;
+    int cells[4];
+    int cellCount = 0;
+    int lines[3];
+    int lineCount = 0;
+    int eliminations = 0;
+};
+
+std::string describeStep(const LogicStep& st) {
+    std::string name = TECHNIQUE_NAMES[st.tech];
+    switch (st.tech) {
+        case T_NAKED_SINGLE:
+            return name + ": " + cellName(st.placeCell) + " can only be " + std::to_string(st.digit);
+        case T_HIDDEN_SINGLE:
+            return name + ": " + std::to_string(st.digit) + " fits only " + cellName(st.placeCell) + " in " + unitName(st.unit);
+        case T_NAKED_PAIR: case T_NAKED_TRIPLE: case T_HIDDEN_PAIR: case T_HIDDEN_TRIPLE: {
+            std::string where;
+            for (int k = 0; k < st.cellCount; k++) where += (k ? "," : "") + cellName(st.cells[k]);
+            return name + " " + digitList(st.digits) + " at " + where + " in " + unitName(st.unit);
+        }
+        case T_POINTING: case T_BOX_LINE:
+            return name + ": " + std::to_string(st.digit) + " in " + unitName(st.unit) + " is confined to " + unitName(st.lines[0]);
+        case T_XWING: case T_SWORDFISH: {
+            std::string where;
+            for (int k = 0; k < st.lineCount; k++) where += (k ? ", " : "") + unitName(st.lines[k]);
+            return name + " on " + std::to_string(st.digit) + " (" + where + ")";
+        }
+        case T_XYWING:
+            return name + ": pivot " + cellName(st.cells[0]) + ", pincers " + cellName(st.cells[1]) + "," + cellName(st.cells[2]) + " remove " + std::to_string(st.digit);
+        case T_XYCHAIN:
+            return name + " from " + cellName(st.cells[0]) + " to " + cellName(st.cells[1]) + " removes " + std::to_string(st.digit);
+        default:
+            return name;
+    }
+}
+
+// Calls fn with each increasing index tuple of the given size (2 or 3) drawn
+// from [0, n); stops at the first call that returns true.
+template <typename F>
+bool anyCombination(int n, int size, F&& fn) {
+    int pick[3];
+    for (pick[0] = 0; pick[0] < n; pick[0]++) {
+        for (pick[1] = pick[0] + 1; pick[1] < n; pick[1]++) {
+            if (size == 2) {
+                if (fn(pick)) return true;
+                continue;
+            }
+            for (pick[2] = pick[1] + 1; pick[2] < n; pick[2]++)
+                if (fn(pick)) return true;
+        }
+    }
+    return false;
+}
+
+// Candidate-grid solver that only applies the techniques above, one step at a
+// time, so it can both grade puzzles and explain the next move.
+struct LogicSolver {
+    static constexpr uint16_t ALL = (1 << N) - 1;
+
+    int cells[N * N];
+    uint16_t cand[N * N];
+    int filled;
+    int counts[T_COUNT];
+
+    void place(int i, int d) {
+        uint16_t bit = 1 << (d - 1);
+        cells[i] = d;
+        cand[i] = 0;
+        filled++;
+        for (int p : tables.peers[i]) cand[p] &= ~bit;
+    }
+
+    int eliminate(int i, uint16_t mask) {
+        uint16_t hit = cand[i] & mask;
+        cand[i] &= ~mask;
+        return __builtin_popcount(hit);
+    }
+
+    bool load(const int grid[N][N]) {
+        filled = 0;
+        for (int t = 0; t < T_COUNT; t++) counts[t] = 0;
+        for (int i = 0; i < N * N; i++) { cells[i] = 0; cand[i] = ALL; }
+        for (int i = 0; i < N * N; i++) {
+            int d = grid[i / N][i % N];
+            if (d == 0) continue;
+            if (!(cand[i] & (1 << (d - 1)))) return false;
+            place(i, d);
+        }
+        return true;
+    }
+
+    bool solved() const { return filled == N * N; }
+
+    // Bit k set when the k-th cell of unit u can still hold digit d.
+    uint16_t positions(int u, int d) const {
+        uint16_t bit = 1 << (d - 1), pos = 0;
+        for (int k = 0; k < N; k++)
+            if (cand[tables.units[u][k]] & bit) pos |= 1 << k;
+        return pos;
+    }
+
+    bool nakedSingle(LogicStep& st) {
+        for (int i = 0; i < N * N; i++) {
+            if (cells[i] || !cand[i] || (cand[i] & (cand[i] - 1))) continue;
+            st.tech = T_NAKED_SINGLE;
+            st.placeCell = i;
+            st.digit = __builtin_ctz(cand[i]) + 1;
+            place(i, st.digit);
+            return true;
+        }
+        return false;
+    }
+
+    bool hiddenSingle(LogicStep& st) {
+        for (int u = 0; u < 3 * N; u++) {
+            uint16_t once = 0, twice = 0;
+            for (int k = 0; k < N; k++) {
+                uint16_t c = cand[tables.units[u][k]];
+                twice |= once & c;
+                once |= c;
+            }
+            uint16_t single = once & ~twice;
+            if (!single) continue;
+            uint16_t bit = single & -single;
+            for (int k = 0; k < N; k++) {
+                int i = tables.units[u][k];
+                if (!(cand[i] & bit)) continue;
+                st.tech = T_HIDDEN_SINGLE;
+                st.placeCell = i;
+                st.digit = __builtin_ctz(bit) + 1;
+                st.unit = u;
+                place(i, st.digit);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool nakedSubset(int size, Technique tech, LogicStep& st) {
+        for (int u = 0; u < 3 * N; u++) {
+            int pool[N], n = 0;
+            for (int k = 0; k < N; k++) {
+                int c = __builtin_popcount(cand[tables.units[u][k]]);
+                if (c >= 2 && c <= size) pool[n++] = k;
+            }
+            bool found = anyCombination(n, size, [&](const int* pick) {
+                uint16_t members = 0, digits = 0;
+                for (int k = 0; k < size; k++) {
+                    members |= 1 << pool[pick[k]];
+                    digits |= cand[tables.units[u][pool[pick[k]]]];
+                }
+                if (__builtin_popcount(digits) != size) return false;
+                int elim = 0;
+                for (int k = 0; k < N; k++)
+                    if (!(members & (1 << k))) elim += eliminate(tables.units[u][k], digits);
+                if (!elim) return false;
+                st.tech = tech;
+                st.unit = u;
+                st.digits = digits;
+                st.eliminations = elim;
+                st.cellCount = size;
+                for (int k = 0; k < size; k++) st.cells[k] = tables.units[u][pool[pick[k]]];
+                return true;
+            });
+            if (found) return true;
+        }
+        return false;
+    }
+
+    bool hiddenSubset(int size, Technique tech, LogicStep& st) {
+        for (int u = 0; u < 3 * N; u++) {
+            uint16_t pos[N];
+            int pool[N], n = 0;
+            for (int d = 1; d <= N; d++) {
+                pos[d - 1] = positions(u, d);
+                int c = __builtin_popcount(pos[d - 1]);
+                if (c >= 2 && c <= size) pool[n++] = d;
+            }
+            bool found = anyCombination(n, size, [&](const int* pick) {
+                uint16_t where = 0, digits = 0;
+                for (int k = 0; k < size; k++) {
+                    where |= pos[pool[pick[k]] - 1];
+                    digits |= 1 << (pool[pick[k]] - 1);
+                }
+                if (__builtin_popcount(where) != size) return false;
+                int elim = 0;
+                for (int k = 0; k < N; k++)
+                    if (where & (1 << k)) elim += eliminate(tables.units[u][k], ALL & ~digits);
+                if (!elim) return false;
+                st.tech = tech;
+                st.unit = u;
+                st.digits = digits;
+                st.eliminations = elim;
+                st.cellCount = 0;
+                for (int k = 0; k < N; k++)
+                    if (where & (1 << k)) st.cells[st.cellCount++] = tables.units[u][k];
+                return true;
+            });
+            if (found) return true;
+        }
+        return false;
+    }
+
+    // Pointing: a box's candidates for d share one row/column. Box/line: a
+    // row's or column's candidates for d share one box.
+    bool intersection(bool pointing, LogicStep& st) {
+        int firstUnit = pointing ? 2 * N : 0, lastUnit = pointing ? 3 * N : 2 * N;
+        for (int u = firstUnit; u < lastUnit; u++) {
+            for (int d = 1; d <= N; d++) {
+                uint16_t bit = 1 << (d - 1);
+                int rowSet = -1, colSet = -1, boxSet = -1;
+                bool sameRow = true, sameCol = true, sameBox = true, any = false;
+                for (int k = 0; k < N; k++) {
+                    int i = tables.units[u][k];
+                    if (!(cand[i] & bit)) continue;
+                    if (any) {
+                        sameRow &= (tables.rowOf[i] == rowSet);
+                        sameCol &= (tables.colOf[i] == colSet);
+                        sameBox &= (tables.boxOf[i] == boxSet);
+                    }
+                    rowSet = tables.rowOf[i];
+                    colSet = tables.colOf[i];
+                    boxSet = tables.boxOf[i];
+                    any = true;
+                }
+                if (!any) continue;
+
+                int targets[2], t = 0;
+                if (pointing) {
+                    if (sameRow) targets[t++] = rowSet;
+                    if (sameCol) targets[t++] = N + colSet;
+                } else if (sameBox) {
+                    targets[t++] = 2 * N + boxSet;
+                }
+                for (int k = 0; k < t; k++) {
+                    int elim = 0;
+                    for (int m = 0; m < N; m++) {
+                        int i = tables.units[targets[k]][m];
+                        bool inside = pointing ? (tables.boxOf[i] == u - 2 * N)
+                                               : (u < N ? tables.rowOf[i] == u : tables.colOf[i] == u - N);
+                        if (!inside) elim += eliminate(i, bit);
+                    }
+                    if (!elim) continue;
+                    st.tech = pointing ? T_POINTING : T_BOX_LINE;
+                    st.unit = u;
+                    st.digit = d;
+                    st.lines[0] = targets[k];
+                    st.lineCount = 1;
+                    st.eliminations = elim;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // X-Wing (size 2) and Swordfish (size 3), with rows or columns as base.
+    bool fish(int size, Technique tech, LogicStep& st) {
+        for (int d = 1; d <= N; d++) {
+            uint16_t bit = 1 << (d - 1);
+            for (int base = 0; base < 2; base++) {
+                int baseUnit = base ? N : 0, coverUnit = base ? 0 : N;
+                uint16_t pos[N];
+                int pool[N], n = 0;
+                for (int l = 0; l < N; l++) {
+                    pos[l] = positions(baseUnit + l, d);
+                    int c = __builtin_popcount(pos[l]);
+                    if (c >= 2 && c <= size) pool[n++] = l;
+                }
+                bool found = anyCombination(n, size, [&](const int* pick) {
+                    uint16_t cover = 0, lines = 0;
+                    for (int k = 0; k < size; k++) {
+                        cover |= pos[pool[pick[k]]];
+                        lines |= 1 << pool[pick[k]];
+                    }
+                    if (__builtin_popcount(cover) != size) return false;
+                    int elim = 0;
+                    for (int c = 0; c < N; c++) {
+                        if (!(cover & (1 << c))) continue;
+                        for (int k = 0; k < N; k++)
+                            if (!(lines & (1 << k))) elim += eliminate(tables.units[coverUnit + c][k], bit);
+                    }
+                    if (!elim) return false;
+                    st.tech = tech;
+                    st.digit = d;
+                    st.lineCount = size;
+                    for (int k = 0; k < size; k++) st.lines[k] = baseUnit + pool[pick[k]];
+                    st.eliminations = elim;
+                    return true;
+                });
+                if (found) return true;
+            }
+        }
+        return false;
+    }
+
+    int eliminateSeenByBoth(int a, int b, uint16_t bit, int skip = -1) {
+        int elim = 0;
+        for (int p : tables.peers[a])
+            if (p != b && p != skip && tables.sees(p, b)) elim += eliminate(p, bit);
+        return elim;
+    }
+
+    bool xyWing(LogicStep& st) {
+        for (int pivot = 0; pivot < N * N; pivot++) {
+            uint16_t pc = cand[pivot];
+            if (__builtin_popcount(pc) != 2) continue;
+            for (int a : tables.peers[pivot]) {
+                uint16_t ac = cand[a];
+                if (__builtin_popcount(ac) != 2 || __builtin_popcount(ac & pc) != 1) continue;
+                uint16_t z = ac & ~pc;
+                uint16_t bc = (pc & ~ac) | z;
+                for (int b : tables.peers[pivot]) {
+                    if (b == a || cand[b] != bc || tables.sees(a, b)) continue;
+                    int elim = eliminateSeenByBoth(a, b, z, pivot);
+                    if (!elim) continue;
+                    st.tech = T_XYWING;
+                    st.digit = __builtin_ctz(z) + 1;
+                    st.cells[0] = pivot;
+                    st.cells[1] = a;
+                    st.cells[2] = b;
+                    st.cellCount = 3;
+                    st.eliminations = elim;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // Chains of bivalue cells: if the start is not z, each link forces the
+    // next cell's other digit; reaching a cell forced to z means one of the
+    // two ends is z, so every cell seeing both loses z.
+    bool xyChain(LogicStep& st) {
+        int queueCell[N * N * N], queueVal[N * N * N];
+        uint8_t seen[N * N][N];
+        for (int s = 0; s < N * N; s++) {
+            if (__builtin_popcount(cand[s]) != 2) continue;
+            for (uint16_t zs = cand[s]; zs; zs &= zs - 1) {
+                uint16_t z = zs & -zs;
+                std::fill(&seen[0][0], &seen[0][0] + N * N * N, 0);
+                int head = 0, tail = 0;
+                int startVal = __builtin_ctz(cand[s] & ~z);
+                queueCell[tail] = s; queueVal[tail++] = startVal;
+                seen[s][startVal] = 1;
+                while (head < tail) {
+                    int c = queueCell[head], v = queueVal[head++];
+                    for (int n : tables.peers[c]) {
+                        uint16_t nc = cand[n];
+                        if (__builtin_popcount(nc) != 2 || !(nc & (1 << v))) continue;
+                        int forced = __builtin_ctz(nc & ~(1 << v));
+                        if (seen[n][forced]) continue;
+                        seen[n][forced] = 1;
+                        if ((1 << forced) == z && n != s) {
+                            int elim = eliminateSeenByBoth(s, n, z);
+                            if (elim) {
+                                st.tech = T_XYCHAIN;
+                                st.digit = __builtin_ctz(z) + 1;
+                                st.cells[0] = s;
+                                st.cells[1] = n;
+                                st.cellCount = 2;
+                                st.eliminations = elim;
+                                return true;
+                            }
+                        }
+                        queueCell[tail] = n; queueVal[tail++] = forced;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    bool step(LogicStep& st) {
+        st = LogicStep();
+        bool found = nakedSingle(st) || hiddenSingle(st)
+            || nakedSubset(2, T_NAKED_PAIR, st) || hiddenSubset(2, T_HIDDEN_PAIR, st)
+            || nakedSubset(3, T_NAKED_TRIPLE, st) || hiddenSubset(3, T_HIDDEN_TRIPLE, st)
+            || intersection(true, st) || intersection(false, st)
+            || fish(2, T_XWING, st) || fish(3, T_SWORDFISH, st)
+            || xyWing(st) || xyChain(st);
+        if (found) counts[st.tech]++;
+        return found;
+    }
+
+    // Runs to completion and returns the grade of the hardest step used.
+    Grade grade(const int grid[N][N], Technique* hardest = nullptr) {
+        if (hardest) *hardest = T_NAKED_SINGLE;
+        if (!load(grid)) return GRADE_DIABOLICAL;
+        LogicStep st;
+        while (!solved() && step(st)) {}
+        int top = 0;
+        for (int t = 0; t < T_COUNT; t++) if (counts[t]) top = t;
+        if (hardest) *hardest = (Technique)top;
+        return solved() ? gradeOf((Technique)top) : GRADE_DIABOLICAL;
+    }
+};
+
+Grade targetGrade = GRADE_NORMAL;
+Grade puzzleGrade = GRADE_NORMAL;
+Technique puzzleHardest = T_NAKED_SINGLE;
+
+// Fills a random solved grid and digs it down towards `holes` empty cells.
+int makePuzzle(int puzzle[N][N], int solved[N][N], int holes, std::mt19937& g) {
+    for (int i = 0; i < N; i++)
+        for (int j = 0; j < N; j++)
+            puzzle[i][j] = 0;
+
+    for (int i = 0; i < N; i += 3) {
+        std::vector<int> nums = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+        std::shuffle(nums.begin(), nums.end(), g);
+        int idx = 0;
+        for (int r = 0; r < 3; r++)
+            for (int c = 0; c < 3; c++)
+                puzzle[i + r][i + c] = nums[idx++];
+    }
+
+    solveSudoku(puzzle);
+    std::copy(&puzzle[0][0], &puzzle[0][0] + N * N, &solved[0][0]);
+    return digHoles(puzzle, holes, g);
+}
+
+// Hard accepts anything that needs more than intersections but no guessing.
+int gradeDistance(Grade got, Grade wanted) {
+    if (got == GRADE_DIABOLICAL) return 100;
+    if (wanted == GRADE_HARD && got == GRADE_EXPERT) return 0;
+    return std::abs((int)got - (int)wanted);
+}
+
+int holesFor(Grade target) {
+    if (target == GRADE_EASY) return 36;
+    if (target == GRADE_NORMAL) return 50;
+    return 58;
+}
+
+// Filling a giant grid by search from an empty board is far too slow, so a
+// valid pattern grid is shuffled instead: digits are relabelled, rows move
+// within their band and bands move as a whole (same for columns and stacks),
+// and the result may be transposed. Each of these keeps the grid valid.
+template <int B>
+void randomSolvedGrid(int* solved, std::mt19937& g) {
+    constexpr int S = B * B;
+    std::vector<int> digits(S);
+    std::iota(digits.begin(), digits.end(), 1);
+    std::shuffle(digits.begin(), digits.end(), g);
+
+    auto lineOrder = [&]() {
+        std::vector<int> bands(B), inner(B), order;
+        std::iota(bands.begin(), bands.end(), 0);
+        std::shuffle(bands.begin(), bands.end(), g);
+        for (int b : bands) {
+            std::iota(inner.begin(), inner.end(), 0);
+            std::shuffle(inner.begin(), inner.end(), g);
+            for (int k : inner) order.push_back(b * B + k);
+        }
+        return order;
+    };
+    std::vector<int> rows = lineOrder(), cols = lineOrder();
+    bool transpose = g() & 1;
+
+    for (int r = 0; r < S; r++) {
+        for (int c = 0; c < S; c++) {
+            int pr = rows[r], pc = cols[c];
+            if (transpose) std::swap(pr, pc);
+            solved[r * S + c] = digits[(B * (pr % B) + pr / B + pc) % S];
+        }
+    }
+}
+
+// Uniqueness checks on giants give up after a number of search nodes; a
+// removal whose check runs out is treated as ambiguous and the clue stays.
+// Most removals are settled far below the first limit, but towards the end
+// of a dig many clues that could go take much longer to prove so. Each pass
+// over the clues left multiplies the limit, until the target is reached or
+// the dig's time budget (per cell of the board) is spent; checks started
+// after that count as ambiguous.
+const long long GIANT_NODE_LIMIT = 100;
+const int GIANT_LIMIT_GROWTH = 4;
+const int GIANT_BUDGET_US_PER_CELL = 2000;
+
+template <int B>
+int makeGiantPuzzle(int* puzzle, int* solved, int holes, std::mt19937& g) {
+    const int cells = B * B * B * B;
+    randomSolvedGrid<B>(solved, g);
+    std::copy(solved, solved + cells, puzzle);
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(cells * GIANT_BUDGET_US_PER_CELL);
+    int dug = 0;
+    for (long long limit = GIANT_NODE_LIMIT; dug < holes && std::chrono::steady_clock::now() < deadline;
+         limit *= GIANT_LIMIT_GROWTH) {
+        dug += digHolesWith(puzzle, cells, holes - dug, g, [&](const int* p, int) {
+            return std::chrono::steady_clock::now() < deadline && countSolutionsOf<B>(p, limit) == 1;
+        });
+    }
+    return dug;
+}
+
+// Variants on the 9x9 board. Each one is a set of 9-cell units that must
+// hold every digit once (rows, columns, boxes or Jigsaw regions, plus the
+// diagonals for X and the four windows for Windoku) and, for Killer, cages
+// whose digits differ and add up to the cage sum.
+enum Variant { V_CLASSIC, V_X, V_WINDOKU, V_JIGSAW, V_KILLER, VARIANT_COUNT };
+const char* VARIANT_NAMES[VARIANT_COUNT] = { "Classic", "X", "Windoku", "Jigsaw", "Killer" };
+
+struct Cage {
+    int sum;
+    std::vector<int> cells;
+};
+
+struct VariantLayout {
+    Variant variant = V_CLASSIC;
+    int region[N * N];                      // box, or Jigsaw region
+    std::vector<std::array<int, N>> units;
+    std::vector<std::vector<int>> unitsOf;  // cell -> indices into units
+    std::vector<Cage> cages;
+    int cageOf[N * N];                      // -1 outside every cage
+    unsigned serial = 0;                    // changes whenever the rules do
+
+    // Rebuilds the units for `v`; Jigsaw takes its regions from `regions`.
+    void build(Variant v, const int* regions = nullptr) {
+        variant = v;
+        units.clear();
+        cages.clear();
+        for (int i = 0; i < N * N; i++) {
+            region[i] = regions ? regions[i] : tables.boxOf[i];
+            cageOf[i] = -1;
+        }
+
+        std::array<int, N> unit;
+        for (int u = 0; u < 2 * N; u++) {
+            std::copy(tables.units[u], tables.units[u] + N, unit.begin());
+            units.push_back(unit);
+        }
+        for (int r = 0; r < N; r++) {
+            int count = 0;
+            for (int i = 0; i < N * N; i++)
+                if (region[i] == r) unit[count++] = i;
+            units.push_back(unit);
+        }
+        if (v == V_X) {
+            for (int k = 0; k < N; k++) unit[k] = k * N + k;
+            units.push_back(unit);
+            for (int k = 0; k < N; k++) unit[k] = k * N + (N - 1 - k);
+            units.push_back(unit);
+        }
+        if (v == V_WINDOKU) {
+            for (int top : {1, 5})
+                for (int left : {1, 5}) {
+                    for (int k = 0; k < N; k++) unit[k] = (top + k / 3) * N + left + k % 3;
+                    units.push_back(unit);
+                }
+        }
+
+        unitsOf.assign(N * N, {});
+        for (size_t u = 0; u < units.size(); u++)
+            for (int i : units[u]) unitsOf[i].push_back(u);
+        touch();
+    }
+
+    void addCage(const std::vector<int>& cells, int sum) {
+        for (int i : cells) cageOf[i] = cages.size();
+        cages.push_back({sum, cells});
+        touch();
+    }
+
+    // Cells that belong to a unit beyond rows, columns and regions.
+    bool inExtraUnit(int i) const {
+        return unitsOf[i].size() > 3;
+    }
+
+    void touch() {
+        static std::atomic<unsigned> next{1};
+        serial = next++;
+    }
+};
+
+// Digit sets (as 9-bit masks) of each size adding up to each sum.
+struct CageCombos {
+    std::vector<uint16_t> masks[N + 1][46];
+
+    CageCombos() {
+        for (int m = 1; m < (1 << N); m++) {
+            int sum = 0;
+            for (int d = 1; d <= N; d++)
+                if (m & (1 << (d - 1))) sum += d;
+            masks[__builtin_popcount(m)][sum].push_back(m);
+        }
+    }
+
+    // Some `size` digits outside `used` add up to `sum`.
+    bool feasible(int size, int sum, uint16_t used) const {
+        if (size == 0) return sum == 0;
+        if (sum < 0 || sum > 45) return false;
+        for (uint16_t m : masks[size][sum])
+            if (!(m & used)) return true;
+        return false;
+    }
+};
+
+const CageCombos cageCombos;
+
+// Dancing Links (Knuth's Algorithm X) over a variant's exact-cover matrix.
+// Primary columns are "cell i is filled" and "unit u holds digit d"; Killer
+// cages add secondary "cage c holds digit d" columns, which may stay empty.
+// Row i * 9 + d - 1 places digit d in cell i. The whole matrix lives in one
+// node array that is built once per layout and reused by every solve: givens
+// are selected (covered) before the search and released afterwards.
+class ExactCover {
+public:
+    int solution[N * N];
+    bool aborted = false;
+    long long nodeLimit = -1;
+
+    void build(const VariantLayout& layout) {
+        this->layout = &layout;
+        serial = layout.serial;
+        int unitCols = layout.units.size() * N;
+        cellCols = N * N;
+        primaryCols = cellCols + unitCols;
+        int columns = primaryCols + layout.cages.size() * N;
+
+        // Rows whose digit fits no combination of their cage are left out.
+        int rowCount = 0, nodeCount = 1 + columns;
+        for (int i = 0; i < N * N; i++) {
+            for (int d = 1; d <= N; d++) {
+                if (!digitFitsCage(i, d)) continue;
+                rowCount++;
+                nodeCount += 1 + layout.unitsOf[i].size() + (layout.cageOf[i] >= 0);
+            }
+        }
+
+        nodes.assign(nodeCount, Node());
+        for (int c = 0; c <= columns; c++) {
+            Node& h = nodes[c];
+            h.up = h.down = c;
+            h.col = c;
+            h.aux = 0;
+            h.left = h.right = c;
+        }
+        // Only primary headers are linked into the root list.
+        for (int c = 0; c <= primaryCols; c++) {
+            nodes[c].left = c == 0 ? primaryCols : c - 1;
+            nodes[c].right = c == primaryCols ? 0 : c + 1;
+        }
+
+        int next = 1 + columns;
+        int cols[2 + 4 + 1];
+        for (int i = 0; i < N * N; i++) {
+            for (int d = 1; d <= N; d++) {
+                int row = i * N + d - 1;
+                rowHead[row] = -1;
+                if (!digitFitsCage(i, d)) continue;
+
+                int count = 0;
+                cols[count++] = 1 + i;
+                for (int u : layout.unitsOf[i]) cols[count++] = 1 + cellCols + u * N + d - 1;
+                if (layout.cageOf[i] >= 0) cols[count++] = 1 + primaryCols + layout.cageOf[i] * N + d - 1;
+
+                rowHead[row] = next;
+                for (int k = 0; k < count; k++) {
+                    Node& n = nodes[next + k];
+                    int c = cols[k];
+                    n.col = c;
+                    n.aux = row;
+                    n.left = next + (k + count - 1) % count;
+                    n.right = next + (k + 1) % count;
+                    n.up = nodes[c].up;
+                    n.down = c;
+                    nodes[nodes[c].up].down = next + k;
+                    nodes[c].up = next + k;
+                    nodes[c].aux++;
+                }
+                next += count;
+            }
+        }
+    }
+
+    bool builtFor(const VariantLayout& layout) const {
+        return this->layout == &layout && serial == layout.serial;
+    }
+
+    // Selects every given. False (with nothing selected) when they clash.
+    bool load(const int* givens) {
+        depth = 0;
+        cageLeft.assign(layout->cages.size(), 0);
+        cageOpen.assign(layout->cages.size(), 0);
+        cageUsed.assign(layout->cages.size(), 0);
+        for (size_t c = 0; c < layout->cages.size(); c++) {
+            cageLeft[c] = layout->cages[c].sum;
+            cageOpen[c] = layout->cages[c].cells.size();
+        }
+        for (int i = 0; i < N * N; i++) {
+            if (givens[i] == 0) continue;
+            int d = givens[i];
+            if (d < 1 || d > N || !select(i * N + d - 1)) {
+                unload();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void unload() {
+        while (depth > 0) deselect(chosen[depth - 1]);
+    }
+
+    // Digits still possible in cell i once the givens are loaded.
+    int liveCandidates(int i) const {
+        return nodes[1 + i].aux;
+    }
+
+    // Counts solutions up to maxCount; the first one lands in `solution`.
+    // With an rng the digits are tried in random order, which turns a solve
+    // from an empty board into a random solved grid.
+    int solve(const int* givens, int maxCount = 1, std::mt19937* rng = nullptr) {
+        found = 0;
+        limit = maxCount;
+        nodesVisited = 0;
+        aborted = false;
+        random = rng;
+        if (!load(givens)) return 0;
+        search();
+        unload();
+        return found;
+    }
+
+private:
+    struct Node {
+        int left, right, up, down;
+        int col;
+        int aux;  // header: live rows in the column; row node: its row
+    };
+
+    const VariantLayout* layout = nullptr;
+    unsigned serial = 0;
+    int cellCols = 0, primaryCols = 0;
+    std::vector<Node> nodes;
+    int rowHead[N * N * N];
+    int chosen[N * N];
+    int depth = 0;
+    std::vector<int> cageLeft, cageOpen;
+    std::vector<uint16_t> cageUsed;
+    int found = 0, limit = 1;
+    long long nodesVisited = 0;
+    std::mt19937* random = nullptr;
+
+    bool digitFitsCage(int i, int d) const {
+        int c = layout->cageOf[i];
+        if (c < 0) return true;
+        const Cage& cage = layout->cages[c];
+        return cageCombos.feasible(cage.cells.size() - 1, cage.sum - d, 1 << (d - 1));
+    }
+
+    void cover(int c) {
+        nodes[nodes[c].right].left = nodes[c].left;
+        nodes[nodes[c].left].right = nodes[c].right;
+        for (int i = nodes[c].down; i != c; i = nodes[i].down) {
+            for (int j = nodes[i].right; j != i; j = nodes[j].right) {
+                nodes[nodes[j].down].up = nodes[j].up;
+                nodes[nodes[j].up].down = nodes[j].down;
+                nodes[nodes[j].col].aux--;
+            }
+        }
+    }
+
+    void uncover(int c) {
+        for (int i = nodes[c].up; i != c; i = nodes[i].up) {
+            for (int j = nodes[i].left; j != i; j = nodes[j].left) {
+                nodes[nodes[j].col].aux++;
+                nodes[nodes[j].down].up = j;
+                nodes[nodes[j].up].down = j;
+            }
+        }
+        nodes[nodes[c].right].left = c;
+        nodes[nodes[c].left].right = c;
+    }
+
+    // A row is still available while none of its columns is covered, i.e.
+    // while it is linked into each of them.
+    bool available(int head) const {
+        int j = head;
+        do {
+            if (nodes[nodes[j].up].down != j) return false;
+            j = nodes[j].right;
+        } while (j != head);
+        return true;
+    }
+
+    // Covers every column of the row, keeping Killer sums reachable.
+    bool select(int row) {
+        int head = rowHead[row];
+        if (head < 0 || !available(head)) return false;
+
+        int i = row / N, d = row % N + 1;
+        int c = layout->cageOf[i];
+        if (c >= 0 && !cageCombos.feasible(cageOpen[c] - 1, cageLeft[c] - d, cageUsed[c] | (1 << (d - 1))))
+            return false;
+        if (c >= 0) {
+            cageLeft[c] -= d;
+            cageOpen[c]--;
+            cageUsed[c] |= 1 << (d - 1);
+        }
+
+        int j = head;
+        do {
+            cover(nodes[j].col);
+            j = nodes[j].right;
+        } while (j != head);
+        chosen[depth++] = row;
+        return true;
+    }
+
+    void deselect(int row) {
+        int head = rowHead[row];
+        for (int j = nodes[head].left; ; j = nodes[j].left) {
+            uncover(nodes[j].col);
+            if (j == head) break;
+        }
+        depth--;
+
+        int i = row / N, d = row % N + 1;
+        int c = layout->cageOf[i];
+        if (c >= 0) {
+            cageLeft[c] += d;
+            cageOpen[c]++;
+            cageUsed[c] &= ~(1 << (d - 1));
+        }
+    }
+
+    void search() {
+        if (nodeLimit >= 0 && ++nodesVisited > nodeLimit) aborted = true;
+        if (aborted) return;
+
+        if (nodes[0].right == 0) {
+            if (found++ == 0) {
+                for (int k = 0; k < depth; k++) solution[chosen[k] / N] = chosen[k] % N + 1;
+            }
+            return;
+        }
+
+        int best = nodes[0].right;
+        for (int c = nodes[best].right; c != 0; c = nodes[c].right)
+            if (nodes[c].aux < nodes[best].aux) best = c;
+        if (nodes[best].aux == 0) return;
+
+        int rows[N], count = 0;
+        for (int r = nodes[best].down; r != best; r = nodes[r].down) rows[count++] = nodes[r].aux;
+        if (random) std::shuffle(rows, rows + count, *random);
+
+        for (int k = 0; k < count && found < limit && !aborted; k++) {
+            if (!select(rows[k])) continue;
+            search();
+            deselect(rows[k]);
+        }
+    }
+};
+
+// One engine per dig worker, each rebuilt only when the layout it serves
+// changes. Engine 0 also serves the game's own thread outside a dig.
+std::vector<ExactCover> engines(1);
+
+ExactCover& engineFor(const VariantLayout& layout, int worker = 0) {
+    ExactCover& engine = engines[worker];
+    if (!engine.builtFor(layout)) engine.build(layout);
+    return engine;
+}
+
+// Uniqueness checks give up after this many search nodes; running out
+// counts as "not unique", as for the giants.
+const long long VARIANT_NODE_LIMIT = 20000;
+
+bool variantUnique(const VariantLayout& layout, const int* puzzle, int worker = 0) {
+    ExactCover& engine = engineFor(layout, worker);
+    engine.nodeLimit = VARIANT_NODE_LIMIT;
+    int found = engine.solve(puzzle, 2);
+    engine.nodeLimit = -1;
+    return found == 1 && !engine.aborted;
+}
+
+// Jigsaw regions: start from the boxes and swap the regions of random
+// neighbouring cells, keeping a swap only when both regions stay connected.
+void randomJigsawRegions(int* region, std::mt19937& g) {
+    for (int i = 0; i < N * N; i++) region[i] = tables.boxOf[i];
+
+    auto connected = [&](int r) {
+        int start = -1, seen = 0;
+        for (int i = 0; i < N * N; i++) if (region[i] == r) { start = i; break; }
+        bool visited[N * N] = {};
+        int stack[N * N], top = 0;
+        stack[top++] = start;
+        visited[start] = true;
+        while (top) {
+            int i = stack[--top];
+            seen++;
+            int row = i / N, col = i % N;
+            int next[4] = { row > 0 ? i - N : -1, row < N - 1 ? i + N : -1,
+                            col > 0 ? i - 1 : -1, col < N - 1 ? i + 1 : -1 };
+            for (int j : next) {
+                if (j < 0 || visited[j] || region[j] != r) continue;
+                visited[j] = true;
+                stack[top++] = j;
+            }
+        }
+        return seen == N;
+    };
+
+    for (int swaps = 0, tries = 0; swaps < 200 && tries < 20000; tries++) {
+        int a = g() % (N * N);
+        int dir = g() % 4;
+        int b = dir == 0 ? a - N : dir == 1 ? a + N : dir == 2 ? a - 1 : a + 1;
+        if (b < 0 || b >= N * N || (dir >= 2 && b / N != a / N)) continue;
+        int ra = region[a], rb = region[b];
+        if (ra == rb) continue;
+
+        // Trading a for a cell of b's region keeps both sizes at 9.
+        std::vector<int> partners;
+        for (int i = 0; i < N * N; i++)
+            if (region[i] == rb && i != b) partners.push_back(i);
+        int c = partners[g() % partners.size()];
+        region[a] = rb;
+        region[c] = ra;
+        if (connected(ra) && connected(rb)) swaps++;
+        else { region[a] = ra; region[c] = rb; }
+    }
+}
+
+// Grows random cages of mostly 2-4 cells over a solved grid, never letting a
+// cage repeat a digit.
+void randomCages(VariantLayout& layout, const int* solved, std::mt19937& g) {
+    std::vector<int> order(N * N);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), g);
+    bool taken[N * N] = {};
+
+    for (int start : order) {
+        if (taken[start]) continue;
+        int size = 2 + g() % 3;
+        std::vector<int> cells = {start};
+        uint16_t used = 1 << (solved[start] - 1);
+        taken[start] = true;
+        while ((int)cells.size() < size) {
+            std::vector<int> frontier;
+            for (int i : cells) {
+                int row = i / N, col = i % N;
+                int next[4] = { row > 0 ? i - N : -1, row < N - 1 ? i + N : -1,
+                                col > 0 ? i - 1 : -1, col < N - 1 ? i + 1 : -1 };
+                for (int j : next)
+                    if (j >= 0 && !taken[j] && !(used & (1 << (solved[j] - 1)))) frontier.push_back(j);
+            }
+            if (frontier.empty()) break;
+            int j = frontier[g() % frontier.size()];
+            cells.push_back(j);
+            used |= 1 << (solved[j] - 1);
+            taken[j] = true;
+        }
+        int sum = 0;
+        for (int i : cells) sum += solved[i];
+        std::sort(cells.begin(), cells.end());
+        layout.addCage(cells, sum);
+    }
+}
+
+// Shared generator for every variant: lay out the rules (random regions for
+// Jigsaw), fill a random solved grid with the exact-cover engine, add cages
+// for Killer, then dig with the engine as the uniqueness check. Killer digs
+// as far as it can, since its cages carry most of the information.
+int makeVariantPuzzle(VariantLayout& layout, Variant v, int* puzzle, int* solved, int holes, std::mt19937& g) {
+    int empty[N * N] = {};
+    while (true) {
+        int regions[N * N];
+        if (v == V_JIGSAW) randomJigsawRegions(regions, g);
+        layout.build(v, v == V_JIGSAW ? regions : nullptr);
+
+        ExactCover& engine = engineFor(layout);
+        engine.nodeLimit = VARIANT_NODE_LIMIT;
+        bool filled = engine.solve(empty, 1, &g) == 1;
+        engine.nodeLimit = -1;
+        if (filled) {
+            std::copy(engine.solution, engine.solution + N * N, solved);
+            break;
+        }
+    }
+
+    if (v == V_KILLER) {
+        randomCages(layout, solved, g);
+        holes = N * N;
+    }
+    std::copy(solved, solved + N * N, puzzle);
+    if ((int)engines.size() < digThreads()) engines.resize(digThreads());
+    return digHolesWith(puzzle, N * N, holes, g,
+                        [&](const int* p, int worker) { return variantUnique(layout, p, worker); });
+}
+
+// Pre-generated puzzle bank (built with --make-bank). Records are sorted by
+// grade and the header holds each grade's offset and count, so choosing a
+// puzzle is one index computation into the mapped file. Each menu level walks
+// its range in a fixed permutation; the position reached is persisted, which
+// is also the record of which puzzles the player has already seen.
+const char* BANK_FILE = "sudoku.bank";
+const char* SEEN_FILE = "sudoku_seen.txt";
+
+struct BankHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    uint64_t bankId;
+    uint32_t offset[GRADE_COUNT];
+    uint32_t count[GRADE_COUNT];
+};
+
+struct BankRecord {
+    uint8_t givens[(N * N + 7) / 8];
+    uint8_t solution[(N * N + 1) / 2];
+    uint8_t grade;
+    uint8_t hardest;
+    uint8_t holes;
+    uint8_t reserved;
+};
+
+const char BANK_MAGIC[8] = {'S', 'D', 'K', 'B', 'A', 'N', 'K', '1'};
+
+void packRecord(const int puzzle[N][N], const int solved[N][N], Grade grade, Technique hardest, BankRecord& rec) {
+    memset(&rec, 0, sizeof(rec));
+    for (int i = 0; i < N * N; i++) {
+        if (puzzle[i / N][i % N]) rec.givens[i / 8] |= 1 << (i % 8);
+        else rec.holes++;
+        rec.solution[i / 2] |= solved[i / N][i % N] << ((i % 2) * 4);
+    }
+    rec.grade = grade;
+    rec.hardest = hardest;
+}
+
+void unpackRecord(const BankRecord& rec, int puzzle[N][N], int solved[N][N]) {
+    for (int i = 0; i < N * N; i++) {
+        int d = (rec.solution[i / 2] >> ((i % 2) * 4)) & 0xF;
+        solved[i / N][i % N] = d;
+        puzzle[i / N][i % N] = (rec.givens[i / 8] & (1 << (i % 8))) ? d : 0;
+    }
+}
+
+struct PuzzleBank {
+    const BankHeader* header = nullptr;
+    const BankRecord* records = nullptr;
+    size_t mappedSize = 0;
+    uint32_t seen[GRADE_COUNT] = {};
+
+    bool open(const char* path) {
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(BankHeader)) { ::close(fd); return false; }
+        void* map = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (map == MAP_FAILED) return false;
+
+        const BankHeader* h = (const BankHeader*)map;
+        size_t total = 0;
+        for (int g = 0; g < GRADE_COUNT; g++) total += h->count[g];
+        bool valid = memcmp(h->magic, BANK_MAGIC, sizeof(BANK_MAGIC)) == 0
+            && h->recordSize == sizeof(BankRecord)
+            && sizeof(BankHeader) + total * sizeof(BankRecord) <= (size_t)st.st_size;
+        for (int g = 0; valid && g < GRADE_COUNT; g++) valid = (size_t)h->offset[g] + h->count[g] <= total;
+        // range() reads Hard and Expert as one run, so Expert must follow Hard.
+        valid = valid && h->offset[GRADE_EXPERT] == (size_t)h->offset[GRADE_HARD] + h->count[GRADE_HARD];
+        if (!valid) { munmap(map, st.st_size); return false; }
+
+        header = h;
+        records = (const BankRecord*)((const char*)map + sizeof(BankHeader));
+        mappedSize = st.st_size;
+        loadSeen();
+        return true;
+    }
+
+    void close() {
+        if (header) munmap((void*)header, mappedSize);
+        header = nullptr;
+        records = nullptr;
+        mappedSize = 0;
+        memset(seen, 0, sizeof(seen));
+    }
+
+    // Menu levels map to grade ranges; Hard also serves Expert puzzles.
+    void range(Grade target, uint32_t& lo, uint32_t& n) const {
+        lo = header->offset[target];
+        n = header->count[target];
+        if (target == GRADE_HARD) n += header->count[GRADE_EXPERT];
+    }
+
+    void loadSeen() {
+        std::ifstream file(SEEN_FILE);
+        uint64_t id;
+        int grade;
+        uint32_t next;
+        while (file >> id >> grade >> next)
+            if (id == header->bankId && grade >= 0 && grade < GRADE_COUNT) seen[grade] = next;
+    }
+
+    void saveSeen() const {
+        std::ofstream file(SEEN_FILE);
+        if (!file.is_open()) return;
+        for (int g = 0; g < GRADE_COUNT; g++)
+            if (seen[g]) file << header->bankId << " " << g << " " << seen[g] << std::endl;
+    }
+
+    bool pick(Grade target, int puzzle[N][N], int solved[N][N], Grade& grade, Technique& hardest) {
+        if (!header) return false;
+        uint32_t lo, n;
+        range(target, lo, n);
+        if (seen[target] >= n) return false;
+
+        uint32_t stride = (uint32_t)(header->bankId % n) | 1;
+        while (std::gcd(stride, n) != 1) stride += 2;
+        uint32_t idx = lo + (uint32_t)(((uint64_t)seen[target] * stride + header->bankId) % n);
+        seen[target]++;
+        saveSeen();
+
+        const BankRecord& rec = records[idx];
+        unpackRecord(rec, puzzle, solved);
+        grade = (Grade)rec.grade;
+        hardest = (Technique)rec.hardest;
+        return true;
+    }
+
+    uint32_t remaining(Grade target) const {
+        if (!header) return 0;
+        uint32_t lo, n;
+        range(target, lo, n);
+        return seen[target] < n ? n - seen[target] : 0;
+    }
+};
+
+PuzzleBank bank;
+bool puzzleFromBank = false;
+
+Variant variant = V_CLASSIC;
+VariantLayout layout;
+
+// Which digits each unit holds, kept current on every entry and erase, so a
+// cell's candidates and conflicts are a few mask operations and a change only
+// touches the units of the cell that changed. Units are the rules' units plus
+// Killer cages; `holders` lists the cells showing each digit.
+struct UnitMasks {
+    std::vector<std::vector<int>> units;    // unit -> cells
+    std::vector<std::vector<int>> unitsOf;  // cell -> units
+    std::vector<uint32_t> used;             // unit -> digits present
+    std::vector<uint8_t> count;             // unit * (MAX_N + 1) + digit -> cells holding it
+    std::vector<int> holders[MAX_N + 1];
+    std::vector<int> slot;                  // cell -> position in holders[its digit]
+
+    void reset(std::vector<std::vector<int>> unitCells, int cells) {
+        units = std::move(unitCells);
+        unitsOf.assign(cells, {});
+        for (size_t u = 0; u < units.size(); u++)
+            for (int i : units[u]) unitsOf[i].push_back(u);
+        used.assign(units.size(), 0);
+        count.assign(units.size() * (MAX_N + 1), 0);
+        for (auto& h : holders) h.clear();
+        slot.assign(cells, -1);
+    }
+
+    void add(int i, int d) {
+        for (int u : unitsOf[i])
+            if (count[u * (MAX_N + 1) + d]++ == 0) used[u] |= 1u << (d - 1);
+        slot[i] = holders[d].size();
+        holders[d].push_back(i);
+    }
+
+    void remove(int i, int d) {
+        for (int u : unitsOf[i])
+            if (--count[u * (MAX_N + 1) + d] == 0) used[u] &= ~(1u << (d - 1));
+        int last = holders[d].back();
+        holders[d][slot[i]] = last;
+        slot[last] = slot[i];
+        holders[d].pop_back();
+        slot[i] = -1;
+    }
+
+    uint32_t candidates(int i, int digits) const {
+        uint32_t taken = 0;
+        for (int u : unitsOf[i]) taken |= used[u];
+        return ((1u << digits) - 1) & ~taken;
+    }
+
+    // Digit d appears more than once in one of cell i's units.
+    bool conflicts(int i, int d) const {
+        for (int u : unitsOf[i])
+            if (count[u * (MAX_N + 1) + d] > 1) return true;
+        return false;
+    }
+};
+
+UnitMasks board;
+int filledCount = 0, correctCount = 0;
+bool autoNotes = false;
+bool tallCells = false;
+bool fullRedraw = true;
+std::vector<int> dirtyCells;
+
+template <int B>
+std::vector<std::vector<int>> boxUnits() {
+    const GridTables<B>& t = GridTables<B>::get();
+    std::vector<std::vector<int>> units;
+    for (int u = 0; u < 3 * B * B; u++) units.emplace_back(t.units[u], t.units[u] + B * B);
+    return units;
+}
+
+// Rebuilds the unit masks from the grid after a new puzzle is dealt.
+void indexBoard() {
+    std::vector<std::vector<int>> units;
+    if (boxSize == 4) units = boxUnits<4>();
+    else if (boxSize == 5) units = boxUnits<5>();
+    else {
+        for (auto& u : layout.units) units.emplace_back(u.begin(), u.end());
+        for (auto& cage : layout.cages) units.push_back(cage.cells);
+    }
+
+    int S = gridSize;
+    board.reset(std::move(units), S * S);
+    filledCount = correctCount = 0;
+    for (int i = 0; i < S * S; i++) {
+        int v = grid[i / S][i % S].val;
+        if (!v) continue;
+        board.add(i, v);
+        filledCount++;
+        if (v == solution[i / S][i % S]) correctCount++;
+    }
+    dirtyCells.clear();
+    fullRedraw = true;
+}
 
-bool isSafe(int grid[N][N], int row, int col, int num) {
-    for (int x = 0; x < N; x++) if (grid[row][x] == num) return false;
-    for (int x = 0; x < N; x++) if (grid[x][col] == num) return false;
-    int startRow = row - row % 3, startCol = col - col % 3;
-    for (int i = 0; i < 3; i++)
-        for (int j = 0; j < 3; j++)
-            if (grid[i + startRow][j + startCol] == num) return false;
-    return true;
+void markDirty(int i) {
+    dirtyCells.push_back(i);
 }
 
-bool solveSudoku(int grid[N][N]) {
-    int row, col;
-    bool isEmpty = false;
-    for (row = 0; row < N; row++) {
-        for (col = 0; col < N; col++) {
-            if (grid[row][col] == 0) { isEmpty = true; goto break_loop; }
-        }
+// Digit d's count in unit u went from `before` to `after`. Only a few cells
+// of the unit can look different: the empty ones showing auto notes when d
+// appeared or disappeared, and the ones holding d when it started or stopped
+// conflicting.
+void markCountChange(int u, int d, int before, int after) {
+    bool presence = autoNotes && (before == 0) != (after == 0);
+    bool conflict = (before > 1) != (after > 1);
+    if (!presence && !conflict) return;
+    for (int j : board.units[u]) {
+        int v = grid[j / gridSize][j % gridSize].val;
+        if (v == 0 ? presence : conflict && v == d) markDirty(j);
     }
-    break_loop:
-    if (!isEmpty) return true; 
+}
+
+void markHoldersDirty(int d) {
+    if (d) for (int j : board.holders[d]) markDirty(j);
+}
 
-    for (int num = 1; num <= 9; num++) {
-        if (isSafe(grid, row, col, num)) {
-            grid[row][col] = num;
-            if (solveSudoku(grid)) return true;
-            grid[row][col] = 0; 
+// Every change of a cell's digit goes through here so the unit masks, the
+// filled/correct counts behind checkWin and the redraw list stay in step.
+// Cells showing the old or new digit are redrawn too when the cursor sits on
+// the cell, since they share its highlight.
+void setValue(int r, int c, int v) {
+    int i = r * gridSize + c;
+    int old = grid[r][c].val;
+    markDirty(i);
+    if (old == v) return;
+
+    bool underCursor = (r == cursorY && c == cursorX);
+    if (underCursor) markHoldersDirty(old);
+    if (old) {
+        board.remove(i, old);
+        filledCount--;
+        if (old == solution[r][c]) correctCount--;
+    }
+    grid[r][c].val = v;
+    if (v) {
+        board.add(i, v);
+        filledCount++;
+        if (v == solution[r][c]) correctCount++;
+    }
+    if (underCursor) markHoldersDirty(v);
+    for (int u : board.unitsOf[i]) {
+        if (old) {
+            int after = board.count[u * (MAX_N + 1) + old];
+            markCountChange(u, old, after + 1, after);
+        }
+        if (v) {
+            int after = board.count[u * (MAX_N + 1) + v];
+            markCountChange(u, v, after - 1, after);
         }
     }
-    return false;
 }
 
-void generateGame() {
-    int tempGrid[N][N] = {}; 
-    std::random_device rd;
-    std::mt19937 g(rd());
+void moveCursor(int x, int y) {
+    int from = cursorY * gridSize + cursorX, to = y * gridSize + x;
+    int oldVal = grid[cursorY][cursorX].val, newVal = grid[y][x].val;
+    markDirty(from);
+    markDirty(to);
+    if (oldVal != newVal) {
+        markHoldersDirty(oldVal);
+        markHoldersDirty(newVal);
+    }
+    // Killer underlines the cursor's cage.
+    if (gridSize == N && variant == V_KILLER && layout.cageOf[from] != layout.cageOf[to]) {
+        for (int j : layout.cages[layout.cageOf[from]].cells) markDirty(j);
+        for (int j : layout.cages[layout.cageOf[to]].cells) markDirty(j);
+    }
+    cursorX = x;
+    cursorY = y;
+}
 
-    mistakes = 0;
-    hints = 3;
-    pencilMode = false;
-    startTime = time(0);
+// Giants and variants skip grading and the bank. Giants dig a share of the
+// board that follows the chosen level, checked with the propagating solver;
+// variants dig to the level's hole count, checked with the exact-cover engine.
+void generateUngraded(std::mt19937& g) {
+    int S = gridSize;
+    std::vector<int> puzzle(S * S), solved(S * S);
+    int holes = S * S * difficulty / (N * N);
+    if (boxSize == 4) makeGiantPuzzle<4>(puzzle.data(), solved.data(), holes, g);
+    else if (boxSize == 5) makeGiantPuzzle<5>(puzzle.data(), solved.data(), holes, g);
+    else makeVariantPuzzle(layout, variant, puzzle.data(), solved.data(), holes, g);
 
-    for (int i = 0; i < N; i += 3) {
-        std::vector<int> nums = {1, 2, 3, 4, 5, 6, 7, 8, 9};
-        std::shuffle(nums.begin(), nums.end(), g);
-        int idx = 0;
-        for (int r = 0; r < 3; r++)
-            for (int c = 0; c < 3; c++)
-                tempGrid[i + r][i + c] = nums[idx++];
+    for (int i = 0; i < S * S; i++) {
+        grid[i / S][i % S].val = puzzle[i];
+        grid[i / S][i % S].fixed = (puzzle[i] != 0);
+        grid[i / S][i % S].notes = 0;
+        solution[i / S][i % S] = solved[i];
     }
+    puzzleFromBank = false;
+}
 
-    solveSudoku(tempGrid);
+// Classic 9x9: a bank puzzle of the target grade, else live generation that
+// keeps the candidate closest to the target until `deadline`.
+void generateClassic(std::mt19937& g, std::chrono::steady_clock::time_point deadline) {
+    layout.build(V_CLASSIC);
+    int bestScore = -1;
+    int bestPuzzle[N][N], bestSolved[N][N];
+    int puzzle[N][N], solved[N][N];
+    LogicSolver grader;
 
-    for (int i = 0; i < N; i++)
-        for (int j = 0; j < N; j++)
-            solution[i][j] = tempGrid[i][j];
+    puzzleFromBank = bank.pick(targetGrade, bestPuzzle, bestSolved, puzzleGrade, puzzleHardest);
+    if (puzzleFromBank) bestScore = 0;
 
-    int holes = difficulty;
-    while (holes > 0) {
-        int r = rand() % N;
-        int c = rand() % N;
-        if (tempGrid[r][c] != 0) {
-            tempGrid[r][c] = 0;
-            holes--;
+    while (bestScore < 0 || (bestScore >= 100 && std::chrono::steady_clock::now() < deadline)) {
+        int holes = makePuzzle(puzzle, solved, difficulty, g);
+        Technique hardest = T_NAKED_SINGLE;
+        Grade got = grader.grade(puzzle, &hardest);
+        int score = gradeDistance(got, targetGrade) * 100 + std::abs(difficulty - holes);
+        if (bestScore < 0 || score < bestScore) {
+            bestScore = score;
+            puzzleGrade = got;
+            puzzleHardest = hardest;
+            std::copy(&puzzle[0][0], &puzzle[0][0] + N * N, &bestPuzzle[0][0]);
+            std::copy(&solved[0][0], &solved[0][0] + N * N, &bestSolved[0][0]);
         }
     }
 
     for (int i = 0; i < N; i++) {
         for (int j = 0; j < N; j++) {
-            grid[i][j].val = tempGrid[i][j];
-            grid[i][j].fixed = (tempGrid[i][j] != 0);
-            grid[i][j].isPencil = false;
+            grid[i][j].val = bestPuzzle[i][j];
+            grid[i][j].fixed = (bestPuzzle[i][j] != 0);
+            grid[i][j].notes = 0;
+            solution[i][j] = bestSolved[i][j];
         }
     }
 }
 
+void generateGame() {
+    std::random_device rd;
+    std::mt19937 g(rd());
+
+    mistakes = 0;
+    hints = 3;
+    pencilMode = false;
+    hintMessage.clear();
+    viewRow = viewCol = 0;
+
+    auto genStart = std::chrono::steady_clock::now();
+    if (boxSize != 3 || variant != V_CLASSIC) generateUngraded(g);
+    else generateClassic(g, genStart + std::chrono::milliseconds(400));
+    indexBoard();
+
+    generationMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - genStart).count();
+    startTime = std::chrono::steady_clock::now();
+}
+
 bool checkWin() {
-    for (int i = 0; i < N; i++)
-        for (int j = 0; j < N; j++)
-            if (grid[i][j].val != solution[i][j]) return false;
-    return true;
+    return filledCount == gridSize * gridSize && correctCount == filledCount;
+}
+
+void revealCell(int r, int c) {
+    grid[r][c].notes = 0;
+    setValue(r, c, solution[r][c]);
+    grid[r][c].fixed = false;
+    hints--;
+}
+
+// Empty cell with the fewest candidates on `board`, random among ties; -1 if
+// the board is already full or contradicts itself.
+template <int B>
+int mostConstrainedCell(const int* board) {
+    BasicSudokuSolver<B> solver;
+    if (!solver.load(board)) return -1;
+
+    std::vector<int> candidates;
+    int fewest = B * B + 1;
+    for (int i = 0; i < B * B * B * B; i++) {
+        if (board[i] != 0) continue;
+        int count = __builtin_popcount(solver.candidates(i));
+        if (count < fewest) { fewest = count; candidates.clear(); }
+        if (count == fewest) candidates.push_back(i);
+    }
+    return candidates.empty() ? -1 : candidates[rand() % candidates.size()];
+}
+
+// Same for a variant, reading candidate counts off the exact-cover columns.
+int mostConstrainedVariantCell(const int* board) {
+    ExactCover& engine = engineFor(layout);
+    if (!engine.load(board)) return -1;
+
+    std::vector<int> candidates;
+    int fewest = N + 1;
+    for (int i = 0; i < N * N; i++) {
+        if (board[i] != 0) continue;
+        int count = engine.liveCandidates(i);
+        if (count < fewest) { fewest = count; candidates.clear(); }
+        if (count == fewest) candidates.push_back(i);
+    }
+    engine.unload();
+    return candidates.empty() ? -1 : candidates[rand() % candidates.size()];
 }
 
+// On classic 9x9, applies logic steps to the player's correct entries until one
+// places a digit, reveals that cell and explains the hardest step that led
+// to it. Giants, variants and boards logic cannot crack reveal the most
+// constrained cell instead.
 void useHint() {
     if (hints <= 0) return;
-    
-    std::vector<std::pair<int, int>> candidates;
-    for(int i=0; i<N; i++) {
-        for(int j=0; j<N; j++) {
-            if (!grid[i][j].fixed && grid[i][j].val != solution[i][j]) {
-                candidates.push_back({i, j});
+
+    int S = gridSize;
+    std::vector<int> board(S * S, 0);
+    for (int i = 0; i < S; i++)
+        for (int j = 0; j < S; j++)
+            if (grid[i][j].val == solution[i][j]) board[i * S + j] = solution[i][j];
+
+    bool classicRules = (boxSize == 3 && variant == V_CLASSIC);
+    LogicSolver logic;
+    int classic[N][N];
+    if (classicRules) std::copy(board.begin(), board.end(), &classic[0][0]);
+    if (classicRules && logic.load(classic)) {
+        LogicStep st, hardest;
+        hardest.tech = T_NAKED_SINGLE;
+        bool any = false;
+        while (logic.step(st)) {
+            if (!any || st.tech > hardest.tech) hardest = st;
+            any = true;
+            if (st.placeCell < 0) continue;
+
+            int r = st.placeCell / N, c = st.placeCell % N;
+            if (grid[r][c].val != solution[r][c]) {
+                if (hardest.placeCell == st.placeCell) hintMessage = describeStep(st);
+                else hintMessage = describeStep(hardest) + ", then " + cellName(st.placeCell) + " = " + std::to_string(st.digit);
+                revealCell(r, c);
+                return;
             }
         }
     }
 
-    if (!candidates.empty()) {
-        int idx = rand() % candidates.size();
-        int r = candidates[idx].first;
-        int c = candidates[idx].second;
-        
-        grid[r][c].val = solution[r][c];
-        grid[r][c].fixed = false;
-        grid[r][c].isPencil = false;
-        hints--;
-    }
-}
-
-void printCentered(int y, std::string text, int attrs = 0) {
-    int startX = (COLS - text.length()) / 2;
-    if (attrs) attron(attrs);
-    mvprintw(y, startX, "%s", text.c_str());
-    if (attrs) attroff(attrs);
-}
-
-void drawLine(int y, int startX, int type) {
-    move(y, startX);
-    if (type == 0) addstr("╔");
-    else if (type == 3) addstr("╚");
-    else if (type == 2) addstr("╠");
-    else addstr("╟");
-
-    for (int i = 0; i < 9; i++) {
-        if (type == 1) addstr("───"); else addstr("═══");
-        if (i == 8) { 
-            if (type == 0) addstr("╗");
-            else if (type == 3) addstr("╝");
-            else if (type == 2) addstr("╣");
-            else addstr("╢");
-        } else if ((i + 1) % 3 == 0) {
-            if (type == 0) addstr("╦");
-            else if (type == 3) addstr("╩");
-            else if (type == 2) addstr("╬");
-            else addstr("╫");
-        } else { 
-            if (type == 0) addstr("╤");
-            else if (type == 3) addstr("╧");
-            else if (type == 2) addstr("╪");
-            else addstr("┼");
-        }
-    }
-}
-
-void drawGrid() {
-    int tableWidth = 37;
-    int startY = (LINES - 21) / 2; 
-    int startX = (COLS - tableWidth) / 2;
-    
-    time_t now = time(0);
-    int elapsed = difftime(now, startTime);
-    int mins = elapsed / 60;
-    int secs = elapsed % 60;
-    
-    mvprintw(startY - 2, startX, "Mistakes: %d/%d", mistakes, MAX_MISTAKES);
-    mvprintw(startY - 2, startX + tableWidth - 10, "Time: %02d:%02d", mins, secs);
+    int cell = !classicRules && boxSize == 3 ? mostConstrainedVariantCell(board.data())
+             : boxSize == 3 ? mostConstrainedCell<3>(board.data())
+             : boxSize == 4 ? mostConstrainedCell<4>(board.data())
+             : mostConstrainedCell<5>(board.data());
+    if (cell < 0) return;
+    hintMessage = (classicRules ? "No logical step found; revealed " : "Revealed ") + cellName(cell, S);
+    revealCell(cell / S, cell % S);
+}
+
+void printCentered(WINDOW* win, int y, std::string text, int attrs = 0) {
+    int startX = (getmaxx(win) - text.length()) / 2;
+    if (attrs) wattron(win, attrs);
+    mvwprintw(win, y, startX, "%s", text.c_str());
+    if (attrs) wattroff(win, attrs);
+}
+
+// Region of a cell for drawing borders: boxes, or the variant's regions on
+// 9x9. Everything off the grid is one more region, so the frame is thick.
+int regionAt(int r, int c) {
+    if (r < 0 || c < 0 || r >= gridSize || c >= gridSize) return -1;
+    if (gridSize == N) return layout.region[r * N + c];
+    return (r / boxSize) * boxSize + c / boxSize;
+}
+
+// Junction joining the strokes around a grid corner; `h` and `v` say whether
+// the horizontal and vertical strokes through it are thick.
+const char* junction(bool up, bool down, bool left, bool right, bool h, bool v) {
+    if (!up) return !left ? "╔" : !right ? "╗" : v ? "╦" : "╤";
+    if (!down) return !left ? "╚" : !right ? "╝" : v ? "╩" : "╧";
+    if (!left) return h ? "╠" : "╟";
+    if (!right) return h ? "╣" : "╢";
+    return h ? (v ? "╬" : "╪") : (v ? "╫" : "┼");
+}
+
+// Draws the horizontal line above grid row `row` (gridSize for the bottom
+// frame) over columns [firstCol, lastCol]. Segments are thick where regions
+// meet. Ends cut off by the viewport get the junction that sits there, and a
+// Killer cage's sum sits on the line above its first cell.
+void drawLine(WINDOW* win, int y, int startX, int row, int firstCol, int lastCol) {
+    wmove(win, y, startX);
+    for (int k = firstCol; k <= lastCol + 1; k++) {
+        bool thickLeft = regionAt(row - 1, k - 1) != regionAt(row, k - 1);
+        bool thickRight = regionAt(row - 1, k) != regionAt(row, k);
+        bool thickUp = regionAt(row - 1, k - 1) != regionAt(row - 1, k);
+        bool thickDown = regionAt(row, k - 1) != regionAt(row, k);
+        waddstr(win, junction(row > 0, row < gridSize, k > 0, k < gridSize,
+                        (k > 0 && thickLeft) || (k < gridSize && thickRight),
+                        (row > 0 && thickUp) || (row < gridSize && thickDown)));
+        if (k > lastCol) break;
+
+        const char* fill = thickRight ? "═" : "─";
+        std::string label;
+        int i = row * N + k;
+        if (variant == V_KILLER && gridSize == N && row < N && layout.cageOf[i] >= 0 &&
+            layout.cages[layout.cageOf[i]].cells[0] == i)
+            label = std::to_string(layout.cages[layout.cageOf[i]].sum);
+        waddstr(win, label.c_str());
+        for (int w = label.size(); w < 3; w++) waddstr(win, fill);
+    }
+}
+
+// Keeps `first` so that [first, first + visible) contains `pos`.
+int followCursor(int first, int pos, int visible) {
+    if (pos < first) first = pos;
+    if (pos >= first + visible) first = pos - visible + 1;
+    return std::max(0, std::min(first, gridSize - visible));
+}
+
+// Where the visible part of the grid sits on screen. Tall cells are 3x3 so
+// that a 9x9 cell can show all nine pencil marks as a mini-grid.
+struct GridView {
+    int firstRow = -1, firstCol = -1, rows = 0, cols = 0;
+    int cellHeight = 1, startY = 0, startX = 0, lines = 0, columns = 0;
+
+    bool operator==(const GridView& o) const {
+        return firstRow == o.firstRow && firstCol == o.firstCol && rows == o.rows && cols == o.cols &&
+               cellHeight == o.cellHeight && lines == o.lines && columns == o.columns;
+    }
+    int lastRow() const { return firstRow + rows - 1; }
+    int lastCol() const { return firstCol + cols - 1; }
+    int width() const { return 4 * cols + 1; }
+    int lineY(int row) const { return startY + (row - firstRow) * (cellHeight + 1); }
+    int cellX(int col) const { return startX + 1 + (col - firstCol) * 4; }
+    bool shows(int r, int c) const {
+        return r >= firstRow && r <= lastRow() && c >= firstCol && c <= lastCol();
+    }
+};
+
+GridView view;
+
+// Giants that do not fit show a window that follows the cursor; with
+// single-line cells it never shrinks below a classic 9x9 so that one always
+// renders in full.
+GridView currentView(WINDOW* win) {
+    int lines = getmaxy(win), cols = getmaxx(win);
+    GridView v;
+    v.cellHeight = (tallCells && gridSize == N) ? 3 : 1;
+    v.rows = v.cellHeight == 1 ? std::min(gridSize, std::max(N, (lines - 7) / 2))
+                               : std::min(gridSize, std::max(3, (lines - 7) / 4));
+    v.cols = std::min(gridSize, std::max(N, (cols - 6) / 4));
+    viewRow = followCursor(viewRow, cursorY, v.rows);
+    viewCol = followCursor(viewCol, cursorX, v.cols);
+    v.firstRow = viewRow;
+    v.firstCol = viewCol;
+    v.startY = (lines - (v.rows * (v.cellHeight + 1) + 3)) / 2;
+    v.startX = (cols - v.width()) / 2;
+    v.lines = lines;
+    v.columns = cols;
+    return v;
+}
+
+void drawCell(WINDOW* win, int r, int c) {
+    if (!view.shows(r, c)) return;
+    int i = r * gridSize + c;
+    const Cell& cell = grid[r][c];
+    int val = cell.val;
+    bool isCursor = (r == cursorY && c == cursorX);
+    bool isHighlighted = (val != 0 && val == grid[cursorY][cursorX].val);
+    bool conflict = (val != 0 && board.conflicts(i, val));
+    uint32_t notes = val ? 0 : autoNotes ? board.candidates(i, gridSize) : cell.notes;
+
+    // Underline X diagonals and Windoku windows, or the cursor's cage.
+    bool marked = false;
+    if (gridSize == N && variant == V_KILLER)
+        marked = layout.cageOf[i] == layout.cageOf[cursorY * N + cursorX];
+    else if (gridSize == N && variant != V_CLASSIC)
+        marked = layout.inExtraUnit(i);
+
+    int colorPair = 1;
+    if (conflict) colorPair = 7;
+    else if (cell.fixed) colorPair = 2;
+    else if (notes) colorPair = 5;
+    else if (val != 0 && val != solution[r][c]) colorPair = 3;
+    else if (val != 0) colorPair = 4;
+
+    int attrs = 0;
+    if (isCursor) attrs = A_REVERSE | COLOR_PAIR(colorPair);
+    else if (isHighlighted && !conflict) attrs = COLOR_PAIR(6);
+    else attrs = COLOR_PAIR(colorPair);
+    if (notes) attrs |= A_DIM;
+    if (marked) attrs |= A_UNDERLINE;
+
+    char text[3][4] = {"   ", " . ", "   "};
+    int mid = view.cellHeight / 2;
+    if (val) {
+        text[mid][1] = digitChar(val);
+    } else if (notes && view.cellHeight == 3) {
+        for (int d = 1; d <= N; d++)
+            text[(d - 1) / 3][(d - 1) % 3] = (notes & (1u << (d - 1))) ? digitChar(d) : ' ';
+    } else if (notes) {
+        text[mid][1] = (notes & (notes - 1)) ? '+' : digitChar(__builtin_ctz(notes) + 1);
+    }
+
+    wattron(win, attrs);
+    int y = view.lineY(r) + 1;
+    for (int k = 0; k < view.cellHeight; k++) mvwaddstr(win, y + k, view.cellX(c), text[view.cellHeight == 1 ? mid : k]);
+    wattroff(win, attrs);
+}
+
+// Borders, separators, scroll markers and the key help; everything on the
+// grid that does not change while playing.
+void drawFrame(WINDOW* win) {
+    int startX = view.startX;
+    for (int r = view.firstRow; r <= view.lastRow() + 1; r++)
+        drawLine(win, view.lineY(r), startX, r, view.firstCol, view.lastCol());
+
+    for (int r = view.firstRow; r <= view.lastRow(); r++) {
+        for (int k = 0; k < view.cellHeight; k++) {
+            int y = view.lineY(r) + 1 + k;
+            mvwaddstr(win, y, startX, regionAt(r, view.firstCol - 1) != regionAt(r, view.firstCol) ? "║" : "│");
+            for (int c = view.firstCol; c <= view.lastCol(); c++)
+                mvwaddstr(win, y, view.cellX(c) + 3, regionAt(r, c) != regionAt(r, c + 1) ? "║" : "│");
+        }
+    }
+
+    // Scroll markers on whichever sides have more grid beyond the window.
+    int tableWidth = view.width();
+    int bottomY = view.lineY(view.lastRow() + 1);
+    int midY = (view.startY + bottomY) / 2;
+    mvwaddstr(win, view.startY, startX + tableWidth + 1, view.firstRow > 0 ? "▲" : " ");
+    mvwaddstr(win, bottomY, startX + tableWidth + 1, view.lastRow() < gridSize - 1 ? "▼" : " ");
+    if (startX >= 2) mvwaddstr(win, midY, startX - 2, view.firstCol > 0 ? "◀" : " ");
+    mvwaddstr(win, midY, startX + tableWidth + 1, view.lastCol() < gridSize - 1 ? "▶" : " ");
+
+    int currentY = bottomY + 1;
+    if (gridSize == N) mvwprintw(win, currentY, startX, "[ARROWS] Move | [1-9] Input | [0/DEL] Clear");
+    else mvwprintw(win, currentY, startX, "[ARROWS] Move | [1-9 A-%c] Input | [0/DEL] Clear", digitChar(gridSize));
+    mvwprintw(win, currentY + 1, startX, "[P] Pencil | [C] Auto Notes | [V] View | [H] Hint | [Q] Quit");
+}
+
+// The clock stops at endTime once the round is won or lost.
+int elapsedMs() {
+    auto now = screen == SCREEN_OVER ? endTime : std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(now - startTime).count();
+}
+
+// How long the game loop may sleep before the timer shows a new second.
+int msToNextTick() {
+    return 1000 - elapsedMs() % 1000;
+}
+
+void drawTimer(WINDOW* win) {
+    int secs = elapsedMs() / 1000;
+    mvwprintw(win, view.startY - 2, view.startX + view.width() - 10, "Time: %02d:%02d", secs / 60, secs % 60);
+}
+
+// Counters, timer, modes and the generation / hint lines.
+void drawHud(WINDOW* win) {
+    int startX = view.startX, startY = view.startY;
+    int tableWidth = view.width();
+    int currentY = view.lineY(view.lastRow() + 1) + 1;
+
+    mvwprintw(win, startY - 2, startX, "Mistakes: %d/%d", mistakes, MAX_MISTAKES);
+    drawTimer(win);
     
-    mvprintw(startY - 1, startX, "Hints: %d", hints);
+    mvwprintw(win, startY - 1, startX, "Hints: %d", hints);
+    mvwprintw(win, startY - 1, startX + 12, autoNotes ? "AUTO NOTES" : "          ");
     if (pencilMode) {
-        attron(A_BOLD | COLOR_PAIR(5));
-        mvprintw(startY - 1, startX + tableWidth - 11, "[ PENCIL ]");
-        attroff(A_BOLD | COLOR_PAIR(5));
+        wattron(win, A_BOLD | COLOR_PAIR(5));
+        mvwprintw(win, startY - 1, startX + tableWidth - 11, "[ PENCIL ]");
+        wattroff(win, A_BOLD | COLOR_PAIR(5));
+    } else {
+        mvwprintw(win, startY - 1, startX + tableWidth - 11, "[ NORMAL ]");
+    }
+
+    wattron(win, A_DIM);
+    if (gridSize == N && variant != V_CLASSIC)
+        mvwprintw(win, currentY + 2, startX, "%s | Generated in %.2f ms", VARIANT_NAMES[variant], generationMs);
+    else if (gridSize == N)
+        mvwprintw(win, currentY + 2, startX, "Grade: %s (%s) | %s in %.2f ms",
+                 GRADE_NAMES[puzzleGrade], TECHNIQUE_NAMES[puzzleHardest],
+                 puzzleFromBank ? "Bank" : "Generated", generationMs);
+    else
+        mvwprintw(win, currentY + 2, startX, "%dx%d | Generated in %.2f ms", gridSize, gridSize, generationMs);
+    wclrtoeol(win);
+    wattroff(win, A_DIM);
+    wmove(win, currentY + 3, startX);
+    wclrtoeol(win);
+    if (!hintMessage.empty()) {
+        wattron(win, COLOR_PAIR(4));
+        mvwprintw(win, currentY + 3, startX, "Hint: %s", hintMessage.c_str());
+        wattroff(win, COLOR_PAIR(4));
+    }
+}
+
+// Redraws what changed since the last frame: the whole grid when the view
+// moved or the terminal changed, otherwise only the cells marked dirty, so a
+// keystroke redraws just the cells whose look it changed.
+void drawGrid(WINDOW* win) {
+    GridView next = currentView(win);
+    if (fullRedraw || !(next == view)) {
+        view = next;
+        werase(win);
+        drawFrame(win);
+        for (int r = view.firstRow; r <= view.lastRow(); r++)
+            for (int c = view.firstCol; c <= view.lastCol(); c++) drawCell(win, r, c);
+        fullRedraw = false;
     } else {
-        mvprintw(startY - 1, startX + tableWidth - 11, "[ NORMAL ]");
+        for (int i : dirtyCells) drawCell(win, i / gridSize, i % gridSize);
     }
+    dirtyCells.clear();
+    drawHud(win);
+}
 
-    int currentY = startY;
-    drawLine(currentY++, startX, 0);
+void drawMenu(WINDOW* win) {
+    const char* sizes[3] = {"Size: 9x9", "Size: 16x16", "Size: 25x25"};
+    std::string variantLabel = std::string("Rules: ") + VARIANT_NAMES[variant];
+    const char* options[6] = {"Easy", "Normal", "Hard", sizes[boxSize - 3], variantLabel.c_str(), "Exit"};
 
-    int cursorVal = grid[cursorY][cursorX].val;
+    werase(win);
+    int midY = getmaxy(win) / 2;
+    int boxW = 20, boxH = 11;
+    int boxX = (getmaxx(win) - boxW) / 2;
+    int boxY = midY - 5;
+    
+    wattron(win, COLOR_PAIR(2));
+    mvwprintw(win, boxY, boxX, "┌──────────────────┐");
+    for(int k=1; k<boxH-1; k++) mvwprintw(win, boxY+k, boxX, "│                  │");
+    mvwprintw(win, boxY+boxH-1, boxX, "└──────────────────┘");
+    wattroff(win, COLOR_PAIR(2));
 
-    for (int i = 0; i < N; i++) {
-        move(currentY, startX);
-        addstr("║"); 
+    printCentered(win, midY - 3, "SUDOKU", A_BOLD);
 
-        for (int j = 0; j < N; j++) {
-            int val = grid[i][j].val;
-            bool isCursor = (i == cursorY && j == cursorX);
-            bool isHighlighted = (val != 0 && val == cursorVal);
-            int colorPair = 1; 
+    for (int i = 0; i < 6; i++) {
+        int attr = (i == menuSelected) ? A_REVERSE : 0;
+        printCentered(win, midY - 1 + i, options[i], attr);
+    }
+}
+
+void drawBanner(WINDOW* win) {
+    int midY = getmaxy(win) / 2;
+    int color = COLOR_PAIR(won ? 2 : 3) | A_BOLD;
+    wattron(win, color);
+    printCentered(win, midY, won ? " VICTORY! " : " GAME OVER (Too many mistakes) ", A_REVERSE);
+    printCentered(win, midY + 1, " Press ENTER ", A_REVERSE);
+    wattroff(win, color);
+}
+
+void startRound() {
+    generateGame();
+    cursorX = 0; cursorY = 0;
+    gameOver = false;
+    screen = SCREEN_PLAYING;
+}
+
+// False on Exit.
+bool menuKey(int ch) {
+    switch(ch) {
+        case KEY_UP: case 'w': if (menuSelected > 0) menuSelected--; break;
+        case KEY_DOWN: case 's': if (menuSelected < 5) menuSelected++; break;
+        case 10: 
+            // Variants are 9x9 only, so picking one resets the size and vice versa.
+            if (menuSelected == 3) {
+                boxSize = boxSize == 5 ? 3 : boxSize + 1;
+                gridSize = boxSize * boxSize;
+                variant = V_CLASSIC;
+                break;
+            }
+            if (menuSelected == 4) {
+                variant = (Variant)((variant + 1) % VARIANT_COUNT);
+                boxSize = 3;
+                gridSize = N;
+                break;
+            }
+            if (menuSelected == 5) return false;
+            if (menuSelected == 0) targetGrade = GRADE_EASY;
+            if (menuSelected == 1) targetGrade = GRADE_NORMAL;
+            if (menuSelected == 2) targetGrade = GRADE_HARD;
+            difficulty = holesFor(targetGrade);
+            startRound();
+            break;
+    }
+    return true;
+}
+
+bool parsePuzzle(const char* line, size_t len, int puzzle[N][N]) {
+    if (len < (size_t)(N * N)) return false;
+    for (int i = 0; i < N * N; i++) {
+        char ch = line[i];
+        if (ch >= '1' && ch <= '9') puzzle[i / N][i % N] = ch - '0';
+        else if (ch == '0' || ch == '.') puzzle[i / N][i % N] = 0;
+        else return false;
+    }
+    return true;
+}
+
+std::string formatPuzzle(const int puzzle[N][N]) {
+    std::string out(N * N, '.');
+    for (int i = 0; i < N * N; i++)
+        if (puzzle[i / N][i % N]) out[i] = '0' + puzzle[i / N][i % N];
+    return out;
+}
+
+// sudoku --grade [file]: one 81-character puzzle per line (0 or . for blanks).
+int runGrader(const char* path) {
+    std::ifstream file;
+    if (path) {
+        file.open(path);
+        if (!file.is_open()) {
+            fprintf(stderr, "cannot open %s\n", path);
+            return 1;
+        }
+    }
+    std::istream& in = path ? file : std::cin;
+
+    LogicSolver grader;
+    int puzzle[N][N];
+    long long total = 0, invalid = 0;
+    long long byGrade[GRADE_COUNT] = {};
+    long long byTechnique[T_COUNT] = {};
+    std::string line;
+    auto start = std::chrono::steady_clock::now();
+
+    while (std::getline(in, line)) {
+        if (!parsePuzzle(line.data(), line.size(), puzzle)) { invalid++; continue; }
+        Technique hardest = T_NAKED_SINGLE;
+        Grade grade = grader.grade(puzzle, &hardest);
+        byGrade[grade]++;
+        for (int t = 0; t < T_COUNT; t++) byTechnique[t] += grader.counts[t];
+        total++;
+        printf("%s %s %s\n", line.substr(0, N * N).c_str(), GRADE_NAMES[grade], TECHNIQUE_NAMES[hardest]);
+    }
+
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fprintf(stderr, "graded %lld puzzles (%lld invalid lines) in %.3f s, %.0f puzzles/sec\n",
+            total, invalid, secs, total / (secs > 0 ? secs : 1e-9));
+    for (int g = 0; g < GRADE_COUNT; g++) fprintf(stderr, "  %-12s %lld\n", GRADE_NAMES[g], byGrade[g]);
+    for (int t = 0; t < T_COUNT; t++) fprintf(stderr, "  %-20s %lld steps\n", TECHNIQUE_NAMES[t], byTechnique[t]);
+    return 0;
+}
+
+// True when `solved` is a complete valid grid that agrees with every given.
+bool validateSolution(const int puzzle[N][N], const int solved[N * N]) {
+    uint16_t rows[N] = {}, cols[N] = {}, boxes[N] = {};
+    for (int i = 0; i < N * N; i++) {
+        int d = solved[i];
+        if (d < 1 || d > N) return false;
+        int given = puzzle[i / N][i % N];
+        if (given && given != d) return false;
+        uint16_t bit = 1 << (d - 1);
+        rows[tables.rowOf[i]] |= bit;
+        cols[tables.colOf[i]] |= bit;
+        boxes[tables.boxOf[i]] |= bit;
+    }
+    for (int k = 0; k < N; k++)
+        if (rows[k] != SudokuSolver::ALL || cols[k] != SudokuSolver::ALL || boxes[k] != SudokuSolver::ALL) return false;
+    return true;
+}
+
+// Streaming batch solver: sudoku --solve [file|-] [--count] [--threads N]
+// [--chunk LINES] [--quiet]. Files are mmapped; stdin is read in large
+// blocks. Input is cut into chunks of whole lines. A reader thread keeps a
+// bounded window of chunks in flight, workers solve them, and the main thread
+// writes each chunk's output as soon as every earlier chunk has been written.
+struct SolveChunk {
+    size_t id = 0;
+    const char* data = nullptr;
+    size_t len = 0;
+    std::string storage;
+    std::string out;
+    std::vector<uint32_t> latencyNs;
+    long long solved = 0, unsolvable = 0, invalid = 0, multiple = 0;
+};
 
-            if (grid[i][j].fixed) {
-                colorPair = 2;
-            } else if (grid[i][j].isPencil) {
-                colorPair = 5;
-            } else if (val != 0 && val != solution[i][j]) {
-                colorPair = 3;
-            } else if (val != 0 && val == solution[i][j]) {
-                colorPair = 4; 
+struct BatchOptions {
+    const char* path = nullptr;
+    bool countSolutions = false;
+    bool quiet = false;
+    int threads = 0;
+    size_t chunkLines = 2048;
+};
+
+void solveChunk(SolveChunk& chunk, const BatchOptions& opt) {
+    SudokuSolver solver;
+    int puzzle[N][N];
+    const char* p = chunk.data;
+    const char* end = chunk.data + chunk.len;
+    chunk.out.reserve(chunk.len + chunk.len / 8);
+
+    while (p < end) {
+        const char* eol = (const char*)memchr(p, '\n', end - p);
+        if (!eol) eol = end;
+        size_t lineLen = eol - p;
+        if (lineLen && p[lineLen - 1] == '\r') lineLen--;
+
+        if (lineLen) {
+            auto t0 = std::chrono::steady_clock::now();
+            const char* verdict = nullptr;
+            int found = 0;
+            if (!parsePuzzle(p, lineLen, puzzle)) {
+                verdict = "invalid";
+                chunk.invalid++;
+            } else {
+                found = solver.solve(&puzzle[0][0], opt.countSolutions ? 2 : 1);
+                if (found == 0) {
+                    verdict = "unsolvable";
+                    chunk.unsolvable++;
+                } else if (!validateSolution(puzzle, solver.firstSolution)) {
+                    verdict = "invalid";
+                    chunk.invalid++;
+                } else {
+                    chunk.solved++;
+                    if (found > 1) chunk.multiple++;
+                }
             }
-            
-            if (isCursor) {
-                attron(A_REVERSE);
-            } else if (isHighlighted && !grid[i][j].isPencil) {
-                attron(COLOR_PAIR(6)); 
+            auto t1 = std::chrono::steady_clock::now();
+            chunk.latencyNs.push_back((uint32_t)std::min<long long>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count(), UINT32_MAX));
+
+            if (!opt.quiet) {
+                if (verdict) {
+                    chunk.out += verdict;
+                } else {
+                    for (int i = 0; i < N * N; i++) chunk.out += (char)('0' + solver.firstSolution[i]);
+                    if (opt.countSolutions) chunk.out += (found > 1) ? " multiple" : " unique";
+                }
+                chunk.out += '\n';
             }
+        }
+        p = eol + 1;
+    }
+}
 
-            if (!(isHighlighted && !isCursor && !grid[i][j].isPencil)) {
-                attron(COLOR_PAIR(colorPair));
+int runBatchSolver(const BatchOptions& opt) {
+    const char* mapped = nullptr;
+    size_t mappedLen = 0;
+    if (opt.path && std::string(opt.path) != "-") {
+        int fd = ::open(opt.path, O_RDONLY);
+        if (fd < 0) { fprintf(stderr, "cannot open %s\n", opt.path); return 1; }
+        struct stat st;
+        fstat(fd, &st);
+        mappedLen = st.st_size;
+        if (mappedLen) {
+            void* m = mmap(nullptr, mappedLen, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (m == MAP_FAILED) { ::close(fd); fprintf(stderr, "cannot map %s\n", opt.path); return 1; }
+            madvise(m, mappedLen, MADV_SEQUENTIAL);
+            mapped = (const char*)m;
+        }
+        ::close(fd);
+    }
+
+    int threads = opt.threads > 0 ? opt.threads : std::max(1u, std::thread::hardware_concurrency());
+    size_t window = threads * 4;
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::deque<SolveChunk*> pending;
+    std::map<size_t, SolveChunk*> finished;
+    size_t produced = 0, inFlight = 0;
+    bool readerDone = false;
+
+    auto submit = [&](SolveChunk* chunk) {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait(lock, [&]{ return inFlight < window; });
+        chunk->id = produced++;
+        inFlight++;
+        pending.push_back(chunk);
+        cv.notify_all();
+    };
+
+    std::thread reader([&] {
+        if (mapped) {
+            size_t pos = 0;
+            while (pos < mappedLen) {
+                size_t stop = pos;
+                for (size_t lines = 0; stop < mappedLen && lines < opt.chunkLines; lines++) {
+                    const char* eol = (const char*)memchr(mapped + stop, '\n', mappedLen - stop);
+                    stop = eol ? (eol - mapped) + 1 : mappedLen;
+                }
+                SolveChunk* chunk = new SolveChunk();
+                chunk->data = mapped + pos;
+                chunk->len = stop - pos;
+                submit(chunk);
+                pos = stop;
+            }
+        } else if (!opt.path || std::string(opt.path) == "-") {
+            std::string carry;
+            std::vector<char> block(opt.chunkLines * (N * N + 2));
+            size_t n;
+            while ((n = fread(block.data(), 1, block.size(), stdin)) > 0) {
+                std::string text = carry;
+                text.append(block.data(), n);
+                size_t lastEol = text.rfind('\n');
+                if (lastEol == std::string::npos) { carry = text; continue; }
+                carry = text.substr(lastEol + 1);
+                text.resize(lastEol + 1);
+                SolveChunk* chunk = new SolveChunk();
+                chunk->storage = std::move(text);
+                chunk->data = chunk->storage.data();
+                chunk->len = chunk->storage.size();
+                submit(chunk);
+            }
+            if (!carry.empty()) {
+                SolveChunk* chunk = new SolveChunk();
+                chunk->storage = std::move(carry);
+                chunk->data = chunk->storage.data();
+                chunk->len = chunk->storage.size();
+                submit(chunk);
             }
-            
-            if (grid[i][j].isPencil) attron(A_DIM);
+        }
+        std::lock_guard<std::mutex> lock(mtx);
+        readerDone = true;
+        cv.notify_all();
+    });
 
-            if (val == 0) printw(" . ");
-            else printw(" %d ", val);
-            
-            if (grid[i][j].isPencil) attroff(A_DIM);
-            if (!(isHighlighted && !isCursor && !grid[i][j].isPencil)) attroff(COLOR_PAIR(colorPair));
-            if (isHighlighted && !grid[i][j].isPencil && !isCursor) attroff(COLOR_PAIR(6));
-            if (isCursor) attroff(A_REVERSE);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&] {
+            while (true) {
+                SolveChunk* chunk;
+                {
+                    std::unique_lock<std::mutex> lock(mtx);
+                    cv.wait(lock, [&]{ return !pending.empty() || readerDone; });
+                    if (pending.empty()) return;
+                    chunk = pending.front();
+                    pending.pop_front();
+                }
+                solveChunk(*chunk, opt);
+                std::lock_guard<std::mutex> lock(mtx);
+                finished[chunk->id] = chunk;
+                cv.notify_all();
+            }
+        });
+    }
 
-            if ((j + 1) % 3 == 0) addstr("║"); 
-            else addstr("│"); 
+    auto start = std::chrono::steady_clock::now();
+    std::vector<uint32_t> latencies;
+    long long solved = 0, unsolvable = 0, invalid = 0, multiple = 0;
+    size_t nextToWrite = 0;
+    while (true) {
+        SolveChunk* chunk;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait(lock, [&]{ return finished.count(nextToWrite) || (readerDone && nextToWrite == produced); });
+            if (!finished.count(nextToWrite)) break;
+            chunk = finished[nextToWrite];
+            finished.erase(nextToWrite);
         }
-        currentY++;
+        if (!chunk->out.empty()) fwrite(chunk->out.data(), 1, chunk->out.size(), stdout);
+        latencies.insert(latencies.end(), chunk->latencyNs.begin(), chunk->latencyNs.end());
+        solved += chunk->solved;
+        unsolvable += chunk->unsolvable;
+        invalid += chunk->invalid;
+        multiple += chunk->multiple;
+        delete chunk;
+        nextToWrite++;
+        std::lock_guard<std::mutex> lock(mtx);
+        inFlight--;
+        cv.notify_all();
+    }
+    fflush(stdout);
+
+    reader.join();
+    for (auto& w : workers) w.join();
+    if (mapped) munmap((void*)mapped, mappedLen);
+
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    size_t total = latencies.size();
+    fprintf(stderr, "puzzles: %zu  solved: %lld  unsolvable: %lld  invalid: %lld", total, solved, unsolvable, invalid);
+    if (opt.countSolutions) fprintf(stderr, "  multiple: %lld", multiple);
+    fprintf(stderr, "\nthreads: %d  time: %.3f s  %.0f puzzles/sec\n", threads, secs, total / (secs > 0 ? secs : 1e-9));
+    if (total) {
+        std::sort(latencies.begin(), latencies.end());
+        auto pct = [&](double q) { return latencies[std::min(total - 1, (size_t)(q * total))] / 1000.0; };
+        fprintf(stderr, "latency us: p50 %.1f  p90 %.1f  p99 %.1f  p99.9 %.1f  max %.1f\n",
+                pct(0.50), pct(0.90), pct(0.99), pct(0.999), latencies.back() / 1000.0);
+    }
+    return 0;
+}
+
+// sudoku --generate COUNT [holes]: prints unique-solution puzzles, one per line.
+int runGenerator(int count, int holes) {
+    std::random_device rd;
+    std::mt19937 g(rd());
+    int puzzle[N][N], solved[N][N];
+    for (int k = 0; k < count; k++) {
+        makePuzzle(puzzle, solved, holes, g);
+        printf("%s\n", formatPuzzle(puzzle).c_str());
+    }
+    return 0;
+}
 
-        if (i < N - 1) {
-            if ((i + 1) % 3 == 0) drawLine(currentY++, startX, 2); 
-            else drawLine(currentY++, startX, 1); 
+// sudoku --bench [file]: times the exact-cover engine against the classic
+// solver on the same puzzles (read from file, or 500 generated ones), both
+// counting up to two solutions as a uniqueness check does. Then generates a
+// few puzzles of every variant and times generation and solving.
+int runBenchmark(const char* path) {
+    std::random_device rd;
+    std::mt19937 g(rd());
+    std::vector<std::array<int, N * N>> puzzles;
+    std::array<int, N * N> flat;
+
+    if (path) {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            fprintf(stderr, "cannot open %s\n", path);
+            return 1;
+        }
+        std::string line;
+        int puzzle[N][N];
+        while (std::getline(file, line))
+            if (parsePuzzle(line.data(), line.size(), puzzle)) {
+                std::copy(&puzzle[0][0], &puzzle[0][0] + N * N, flat.begin());
+                puzzles.push_back(flat);
+            }
+    } else {
+        int puzzle[N][N], solved[N][N];
+        for (int k = 0; k < 500; k++) {
+            makePuzzle(puzzle, solved, 55, g);
+            std::copy(&puzzle[0][0], &puzzle[0][0] + N * N, flat.begin());
+            puzzles.push_back(flat);
         }
     }
+    if (puzzles.empty()) {
+        fprintf(stderr, "no puzzles\n");
+        return 1;
+    }
 
-    drawLine(currentY++, startX, 3);
-    
-    mvprintw(currentY, startX, "[ARROWS] Move | [1-9] Input | [0/DEL] Clear");
-    mvprintw(currentY + 1, startX, "[P] Pencil Mode | [H] Hint | [Q] Quit");
+    SudokuSolver classic;
+    VariantLayout classicLayout;
+    classicLayout.build(V_CLASSIC);
+    ExactCover& dlx = engineFor(classicLayout);
+
+    auto timeSolver = [&](auto&& solveOne) {
+        auto start = std::chrono::steady_clock::now();
+        for (auto& p : puzzles) solveOne(p.data());
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / puzzles.size();
+    };
+    double classicUs = timeSolver([&](const int* p) { classic.solve(p, 2); });
+    double dlxUs = timeSolver([&](const int* p) { dlx.solve(p, 2); });
+
+    int mismatches = 0;
+    for (auto& p : puzzles) {
+        int a = classic.solve(p.data(), 2), b = dlx.solve(p.data(), 2);
+        if (a != b || (a >= 1 && !std::equal(dlx.solution, dlx.solution + N * N, classic.firstSolution))) mismatches++;
+    }
+    printf("%zu puzzles, counting to 2 solutions\n", puzzles.size());
+    printf("  classic solver   %8.1f us/puzzle\n", classicUs);
+    printf("  exact cover      %8.1f us/puzzle\n", dlxUs);
+    printf("  mismatches       %8d\n", mismatches);
+
+    printf("\nvariant      gen ms   holes  solve us\n");
+    for (int v = 0; v < VARIANT_COUNT; v++) {
+        const int rounds = 20;
+        double genMs = 0, solveUs = 0;
+        int holes = 0;
+        for (int k = 0; k < rounds; k++) {
+            VariantLayout variantLayout;
+            int puzzle[N * N], solved[N * N];
+            auto start = std::chrono::steady_clock::now();
+            holes += makeVariantPuzzle(variantLayout, (Variant)v, puzzle, solved, 58, g);
+            auto mid = std::chrono::steady_clock::now();
+            engineFor(variantLayout).solve(puzzle, 2);
+            auto end = std::chrono::steady_clock::now();
+            genMs += std::chrono::duration<double, std::milli>(mid - start).count();
+            solveUs += std::chrono::duration<double, std::micro>(end - mid).count();
+        }
+        printf("  %-9s %7.2f %7.1f %9.1f\n", VARIANT_NAMES[v], genMs / rounds, (double)holes / rounds, solveUs / rounds);
+    }
+    return 0;
 }
 
-void showMenu() {
-    int selected = 0;
-    const char* options[4] = {"Easy", "Normal", "Hard", "Exit"};
-    
-    while (true) {
-        clear();
-        int midY = LINES / 2;
-        int boxW = 20, boxH = 10;
-        int boxX = (COLS - boxW) / 2;
-        int boxY = midY - 5;
-        
-        attron(COLOR_PAIR(2));
-        mvprintw(boxY, boxX, "┌──────────────────┐");
-        for(int k=1; k<boxH-1; k++) mvprintw(boxY+k, boxX, "│                  │");
-        mvprintw(boxY+boxH-1, boxX, "└──────────────────┘");
-        attroff(COLOR_PAIR(2));
-
-        printCentered(midY - 3, "SUDOKU", A_BOLD);
-
-        for (int i = 0; i < 4; i++) {
-            int attr = (i == selected) ? A_REVERSE : 0;
-            printCentered(midY - 1 + i, options[i], attr);
-        }
-
-        int ch = getch();
-        switch(ch) {
-            case KEY_UP: case 'w': if (selected > 0) selected--; break;
-            case KEY_DOWN: case 's': if (selected < 3) selected++; break;
-            case 10: 
-                if (selected == 0) difficulty = 30;
-                if (selected == 1) difficulty = 40;
-                if (selected == 2) difficulty = 55;
-                if (selected == 3) { endwin(); exit(0); }
-                return;
+// sudoku --make-bank [file] [perLevel]: fills a puzzle bank with perLevel
+// puzzles for each menu level (Easy, Normal, Hard/Expert).
+int runBankBuilder(const char* path, int perLevel) {
+    std::random_device rd;
+    std::mt19937 g(rd());
+    std::vector<BankRecord> buckets[GRADE_COUNT];
+    const Grade levels[3] = { GRADE_EASY, GRADE_NORMAL, GRADE_HARD };
+    LogicSolver grader;
+    int puzzle[N][N], solved[N][N];
+    long long made = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    auto levelCount = [&](Grade level) {
+        size_t n = buckets[level].size();
+        if (level == GRADE_HARD) n += buckets[GRADE_EXPERT].size();
+        return (int)n;
+    };
+
+    for (Grade level : levels) {
+        while (levelCount(level) < perLevel) {
+            makePuzzle(puzzle, solved, holesFor(level), g);
+            made++;
+            Technique hardest = T_NAKED_SINGLE;
+            Grade got = grader.grade(puzzle, &hardest);
+            if (got == GRADE_DIABOLICAL) continue;
+            Grade slot = (got == GRADE_EXPERT) ? GRADE_HARD : got;
+            if (levelCount(slot) >= perLevel) continue;
+            BankRecord rec;
+            packRecord(puzzle, solved, got, hardest, rec);
+            buckets[got].push_back(rec);
         }
+        fprintf(stderr, "%s: %d puzzles\n", GRADE_NAMES[level], levelCount(level));
+    }
+
+    BankHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, BANK_MAGIC, sizeof(BANK_MAGIC));
+    header.version = 1;
+    header.recordSize = sizeof(BankRecord);
+    header.bankId = ((uint64_t)rd() << 32) | rd();
+    uint32_t offset = 0;
+    for (int k = 0; k < GRADE_COUNT; k++) {
+        header.offset[k] = offset;
+        header.count[k] = buckets[k].size();
+        offset += buckets[k].size();
+    }
+
+    std::ofstream out(path, std::ios::binary);
+    if (!out.is_open()) {
+        fprintf(stderr, "cannot write %s\n", path);
+        return 1;
     }
+    out.write((const char*)&header, sizeof(header));
+    for (int k = 0; k < GRADE_COUNT; k++)
+        out.write((const char*)buckets[k].data(), buckets[k].size() * sizeof(BankRecord));
+
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fprintf(stderr, "wrote %u puzzles to %s (%lld generated, %.1f s)\n", offset, path, made, secs);
+    return 0;
 }
 
-int main() {
-    setlocale(LC_ALL, ""); 
-    srand(time(0));
+// One keystroke of play; whatever it changes is marked for the next drawGrid.
+void playKey(int ch) {
+    // On giants uppercase letters are digits, lowercase stay commands.
+    int num = 0;
+    if (ch >= '1' && ch <= '9') num = ch - '0';
+    else if (gridSize > 9 && ch >= 'A' && ch < 'A' + gridSize - 9) num = ch - 'A' + 10;
+
+    Cell& cell = grid[cursorY][cursorX];
+    if (num && !cell.fixed) {
+        if (pencilMode) {
+            // Pencil marks toggle; a mark on a filled cell replaces its digit.
+            setValue(cursorY, cursorX, 0);
+            cell.notes ^= 1u << (num - 1);
+        } else {
+            cell.notes = 0;
+            setValue(cursorY, cursorX, num);
+            if (num != solution[cursorY][cursorX]) {
+                mistakes++;
+            }
+        }
+    }
+    if (num) return;
+
+    switch (ch) {
+        case KEY_LEFT: case 'a':  moveCursor((cursorX - 1 + gridSize) % gridSize, cursorY); break;
+        case KEY_RIGHT: case 'd': moveCursor((cursorX + 1) % gridSize, cursorY); break;
+        case KEY_UP: case 'w':    moveCursor(cursorX, (cursorY - 1 + gridSize) % gridSize); break;
+        case KEY_DOWN: case 's':  moveCursor(cursorX, (cursorY + 1) % gridSize); break;
+        case 'q': gameOver = true; break; 
+        
+        case 'p': case 'P': pencilMode = !pencilMode; break;
+        case 'h': case 'H': useHint(); break;
+        case 'c': case 'C': autoNotes = !autoNotes; fullRedraw = true; break;
+        case 'v': case 'V': tallCells = !tallCells; break;
+
+        case '0': case KEY_BACKSPACE: case 127: case KEY_DC:
+            if (!cell.fixed) {
+                cell.notes = 0;
+                setValue(cursorY, cursorX, 0);
+            }
+            break;
+    }
+}
 
-    initscr();
-    cbreak();
-    noecho();
-    curs_set(0);
-    keypad(stdscr, TRUE);
-    nodelay(stdscr, TRUE);
+void init() {
+    srand(time(0));
+    bank.open(BANK_FILE);
+    screen = SCREEN_MENU;
+    menuSelected = 0;
 
     if (has_colors()) {
-        start_color();
         init_pair(1, COLOR_CYAN, COLOR_BLACK);
         init_pair(2, COLOR_GREEN, COLOR_BLACK);
         init_pair(3, COLOR_RED, COLOR_BLACK);
         init_pair(4, COLOR_YELLOW, COLOR_BLACK);
         init_pair(5, COLOR_WHITE, COLOR_BLACK);
         init_pair(6, COLOR_MAGENTA, COLOR_BLACK);
+        init_pair(7, COLOR_WHITE, COLOR_RED);
     }
+    tallCells = (LINES >= 4 * N + 8);
+}
 
-    while (true) {
-        nodelay(stdscr, FALSE);
-        showMenu();
-        generateGame();
-        
-        nodelay(stdscr, TRUE);
-        cursorX = 0; cursorY = 0;
-        gameOver = false;
-        
-        while (!gameOver) {
-            drawGrid();
-
-            if (checkWin()) {
-                nodelay(stdscr, FALSE);
-                attron(COLOR_PAIR(2) | A_BOLD);
-                printCentered(LINES/2, " VICTORY! ", A_REVERSE);
-                printCentered(LINES/2 + 1, " Press ENTER ", A_REVERSE);
-                attroff(COLOR_PAIR(2) | A_BOLD);
-                refresh();
-                while(getch() != 10);
-                break;
-            }
-            
-            if (mistakes >= MAX_MISTAKES) {
-                nodelay(stdscr, FALSE);
-                attron(COLOR_PAIR(3) | A_BOLD);
-                printCentered(LINES/2, " GAME OVER (Too many mistakes) ", A_REVERSE);
-                printCentered(LINES/2 + 1, " Press ENTER ", A_REVERSE);
-                attroff(COLOR_PAIR(3) | A_BOLD);
-                refresh();
-                while(getch() != 10);
-                break;
-            }
+bool handleKey(int ch) {
+    if (screen == SCREEN_MENU) return menuKey(ch);
+    if (screen == SCREEN_OVER) {
+        if (ch == 10) {
+            menuSelected = 0;
+            screen = SCREEN_MENU;
+        }
+        return true;
+    }
 
-            int ch = getch();
-            
-            if (ch == ERR) {
-                napms(100);
-                continue;
-            }
+    playKey(ch);
+    if (gameOver) {
+        menuSelected = 0;
+        screen = SCREEN_MENU;
+    } else if (checkWin() || mistakes >= MAX_MISTAKES) {
+        won = checkWin();
+        endTime = std::chrono::steady_clock::now();
+        screen = SCREEN_OVER;
+    }
+    return true;
+}
 
-            switch (ch) {
-                case KEY_LEFT: case 'a':  cursorX = (cursorX - 1 + 9) % 9; break;
-                case KEY_RIGHT: case 'd': cursorX = (cursorX + 1) % 9; break;
-                case KEY_UP: case 'w':    cursorY = (cursorY - 1 + 9) % 9; break;
-                case KEY_DOWN: case 's':  cursorY = (cursorY + 1) % 9; break;
-                case 'q': gameOver = true; break; 
-                
-                case 'p': case 'P': pencilMode = !pencilMode; break;
-                case 'h': case 'H': useHint(); break;
-
-                case '1': case '2': case '3':
-                case '4': case '5': case '6':
-                case '7': case '8': case '9':
-                    if (!grid[cursorY][cursorX].fixed) {
-                        int num = ch - '0';
-                        grid[cursorY][cursorX].val = num;
-                        
-                        if (pencilMode) {
-                            grid[cursorY][cursorX].isPencil = true;
-                        } else {
-                            grid[cursorY][cursorX].isPencil = false;
-                            if (num != solution[cursorY][cursorX]) {
-                                mistakes++;
-                            }
-                        }
-                    }
-                    break;
-                case '0': case KEY_BACKSPACE: case 127: case KEY_DC:
-                    if (!grid[cursorY][cursorX].fixed) {
-                        grid[cursorY][cursorX].val = 0;
-                        grid[cursorY][cursorX].isPencil = false;
-                    }
-                    break;
-            }
+// A key repaints only the cells it changed; a tick, only the HUD with the
+// timer.
+void render(WINDOW* win) {
+    if (screen == SCREEN_MENU) {
+        drawMenu(win);
+        return;
+    }
+    drawGrid(win);
+    if (screen == SCREEN_OVER) drawBanner(win);
+}
+
+// A round ticks as the timer reaches its next second.
+int tickInterval() {
+    return screen == SCREEN_PLAYING ? msToNextTick() : 0;
+}
+
+void teardown() {
+    bank.close();
+}
+
+const GamePlugin plugin = {
+    GAME_PLUGIN_ABI_VERSION, "sudoku", 0, init, handleKey, nullptr, render, teardown, tickInterval,
+};
+
+extern "C" const GamePlugin* game_plugin() { return &plugin; }
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string(argv[1]) == "--grade") return runGrader(argc > 2 ? argv[2] : nullptr);
+    if (argc > 1 && std::string(argv[1]) == "--generate")
+        return runGenerator(argc > 2 ? atoi(argv[2]) : 1, argc > 3 ? atoi(argv[3]) : 55);
+    if (argc > 1 && std::string(argv[1]) == "--solve") {
+        BatchOptions opt;
+        for (int k = 2; k < argc; k++) {
+            std::string arg = argv[k];
+            if (arg == "--count") opt.countSolutions = true;
+            else if (arg == "--quiet") opt.quiet = true;
+            else if (arg == "--threads" && k + 1 < argc) opt.threads = atoi(argv[++k]);
+            else if (arg == "--chunk" && k + 1 < argc) opt.chunkLines = std::max(1, atoi(argv[++k]));
+            else opt.path = argv[k];
         }
+        return runBatchSolver(opt);
     }
+    if (argc > 1 && std::string(argv[1]) == "--bench") return runBenchmark(argc > 2 ? argv[2] : nullptr);
+    if (argc > 1 && std::string(argv[1]) == "--make-bank")
+        return runBankBuilder(argc > 2 ? argv[2] : BANK_FILE, argc > 3 ? atoi(argv[3]) : 500);
 
-    endwin();
-    return 0;
+    setlocale(LC_ALL, "");
+    return runGamePlugin(&plugin);
 }
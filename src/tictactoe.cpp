@@ -1,36 +1,15 @@
-#include <iostream>
+#include <ncurses.h>
 #include <vector>
 #include <string>
-#include <unistd.h>
-#include <termios.h>
-#include <sys/ioctl.h>
-#include <cstdio>
+#include <clocale>
 #include <ctime>
 #include <cstdlib>
 #include <algorithm>
+#include "game_plugin.h"
 
-#define COLOR_RESET  "\033[0m"
-#define COLOR_RED    "\033[1;31m"
-#define COLOR_CYAN   "\033[1;36m"
-#define COLOR_GREEN  "\033[1;32m"
-#define COLOR_YELLOW "\033[1;33m"
-#define COLOR_GRID   "\033[90m"
-#define BG_SELECTED  "\033[47m"
-
-struct TermConfig {
-    struct termios orig_termios;
-    TermConfig() {
-        tcgetattr(STDIN_FILENO, &orig_termios);
-        struct termios raw = orig_termios;
-        raw.c_lflag &= ~(ECHO | ICANON);
-        tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw);
-        std::cout << "\033[?1000h\033[?25l";
-    }
-    ~TermConfig() {
-        std::cout << "\033[?1000l\033[?25h";
-        tcsetattr(STDIN_FILENO, TCSAFLUSH, &orig_termios);
-    }
-};
+// Color pairs. The selected cell is drawn on white, with its own pairs for
+// the marks so they keep their colors there.
+enum Pair { PAIR_X = 1, PAIR_O, PAIR_TITLE, PAIR_CHOICE, PAIR_GRID, PAIR_SELECTED, PAIR_X_SELECTED, PAIR_O_SELECTED };
 
 enum GameState { STATE_MENU, STATE_SETTINGS, STATE_GAME };
 enum Difficulty { DIFF_EASY, DIFF_MEDIUM, DIFF_HARD, DIFF_IMPOSSIBLE };
@@ -52,16 +31,45 @@ class Game {
     int menuSelection;
 
     int boardRow, boardCol; 
+    int originY, originX;  // screen position of the window last drawn into
     std::string message;
+    int messagePair;
+
+    // The bot waits this long before its move, so the player sees the board
+    // change in two steps; the host's tick makes the move.
+    int botDelayMs;
 
 public:
-    Game() : selX(1), selY(1), currentPlayer('X'), running(false), 
-             vsComputer(false), currentState(STATE_MENU), 
-             menuSelection(0), exitProgram(false),
-             difficulty(DIFF_MEDIUM), playerStarts(true), settingsRow(0) {
+    Game() : selX(1), selY(1), currentPlayer('X'), currentState(STATE_MENU),
+             running(false), vsComputer(false), exitProgram(false),
+             difficulty(DIFF_MEDIUM), playerStarts(true), settingsRow(0),
+             menuSelection(0), originY(0), originX(0), messagePair(0), botDelayMs(0) {
         std::srand(std::time(0));
     }
 
+    void enter() {
+        currentState = STATE_MENU;
+        exitProgram = false;
+        running = false;
+    }
+
+    void setMessage(const std::string& text, int pair) {
+        message = text;
+        messagePair = pair;
+    }
+
+    bool botToMove() const {
+        return currentState == STATE_GAME && running && vsComputer && currentPlayer == 'O';
+    }
+
+    int tickInterval() const {
+        return botToMove() ? botDelayMs : 0;
+    }
+
+    void tick() {
+        if (botToMove()) computerMove();
+    }
+
     void resetBoard() {
         for(int i=0; i<3; i++)
             for(int j=0; j<3; j++)
@@ -71,73 +79,67 @@ public:
         
         currentPlayer = playerStarts ? 'X' : 'O';
         
-        if (currentPlayer == 'X') message = std::string(COLOR_RED) + "Player X's turn" + std::string(COLOR_RESET);
-        else message = std::string(COLOR_CYAN) + "Bot O is thinking..." + std::string(COLOR_RESET);
+        if (currentPlayer == 'X') setMessage("Player X's turn", PAIR_X);
+        else setMessage("Bot O is thinking...", PAIR_O);
 
-        if (vsComputer && !playerStarts) {
-            drawGame();
-            usleep(500000);
-            computerMove();
-        }
+        if (vsComputer && !playerStarts) botDelayMs = 500;
     }
 
-    void moveTo(int r, int c) {
-        std::cout << "\033[" << (boardRow + r) << ";" << (boardCol + c) << "H";
+    void put(WINDOW* win, int r, int c, const std::string& text, int attrs = 0) {
+        if (attrs) wattron(win, attrs);
+        mvwaddstr(win, boardRow + r, boardCol + c, text.c_str());
+        if (attrs) wattroff(win, attrs);
     }
 
-    void printCellLine(int cellR, int cellC, int lineIndex) {
+    void printCellLine(WINDOW* win, int cellR, int cellC, int lineIndex) {
         bool isSelected = (cellR == selX && cellC == selY && running && currentPlayer == 'X'); 
         if (vsComputer && currentPlayer == 'O') isSelected = false;
 
-        if (isSelected) std::cout << BG_SELECTED;
-        
+        int back = isSelected ? COLOR_PAIR(PAIR_SELECTED) : 0;
         if (lineIndex == 1) { 
             char sym = board[cellR][cellC];
-            std::cout << "   ";
-            if (sym == 'X') std::cout << COLOR_RED << "X" << COLOR_RESET;
-            else if (sym == 'O') std::cout << COLOR_CYAN << "O" << COLOR_RESET;
-            else std::cout << " ";
-            if (isSelected) std::cout << BG_SELECTED << "   " << COLOR_RESET;
-            else std::cout << "   ";
+            addText(win, "   ", back);
+            if (sym == 'X') addText(win, "X", COLOR_PAIR(isSelected ? PAIR_X_SELECTED : PAIR_X) | A_BOLD);
+            else if (sym == 'O') addText(win, "O", COLOR_PAIR(isSelected ? PAIR_O_SELECTED : PAIR_O) | A_BOLD);
+            else addText(win, " ", back);
+            addText(win, "   ", back);
         } else { 
-            std::cout << "       ";
-            if (isSelected) std::cout << COLOR_RESET;
+            addText(win, "       ", back);
         }
     }
 
-    void drawMenu() {
-        struct winsize w;
-        ioctl(STDOUT_FILENO, TIOCGWINSZ, &w);
-        boardRow = (w.ws_row - 12) / 2;
-        boardCol = (w.ws_col - 30) / 2;
+    static void addText(WINDOW* win, const char* text, int attrs) {
+        if (attrs) wattron(win, attrs);
+        waddstr(win, text);
+        if (attrs) wattroff(win, attrs);
+    }
+
+    void drawMenu(WINDOW* win) {
+        boardRow = (getmaxy(win) - 12) / 2;
+        boardCol = (getmaxx(win) - 30) / 2;
 
-        std::cout << "\033[2J"; 
-        moveTo(0, 5); std::cout << COLOR_CYAN << "TIC-TAC-TOE" << COLOR_RESET;
+        werase(win);
+        put(win, 0, 5, "TIC-TAC-TOE", COLOR_PAIR(PAIR_O) | A_BOLD);
         
         const char* opts[] = {"1 Player (vs Bot)", "2 Players (Local)", "Exit"};
         for(int i=0; i<3; i++) {
-            moveTo(3 + i*2, 0);
-            if (menuSelection == i) std::cout << COLOR_YELLOW << "> " << opts[i] << COLOR_RESET;
-            else std::cout << "  " << opts[i];
+            if (menuSelection == i) put(win, 3 + i*2, 0, std::string("> ") + opts[i], COLOR_PAIR(PAIR_CHOICE) | A_BOLD);
+            else put(win, 3 + i*2, 0, std::string("  ") + opts[i]);
         }
 
-        moveTo(10, 0);
-        std::cout << COLOR_GRID << "Use Arrows & Enter" << COLOR_RESET;
-        std::cout << std::flush;
+        put(win, 10, 0, "Use Arrows & Enter", COLOR_PAIR(PAIR_GRID));
     }
 
-    void drawSettings() {
-        struct winsize w;
-        ioctl(STDOUT_FILENO, TIOCGWINSZ, &w);
-        boardRow = (w.ws_row - 12) / 2;
-        boardCol = (w.ws_col - 40) / 2;
+    void drawSettings(WINDOW* win) {
+        boardRow = (getmaxy(win) - 12) / 2;
+        boardCol = (getmaxx(win) - 40) / 2;
 
-        std::cout << "\033[2J";
-        moveTo(0, 10); std::cout << COLOR_GREEN << "GAME SETTINGS" << COLOR_RESET;
+        werase(win);
+        put(win, 0, 10, "GAME SETTINGS", COLOR_PAIR(PAIR_TITLE) | A_BOLD);
 
-        moveTo(3, 0);
-        if (settingsRow == 0) std::cout << COLOR_YELLOW << "> Difficulty: " << COLOR_RESET;
-        else std::cout << "  Difficulty: ";
+        const int choice = COLOR_PAIR(PAIR_CHOICE) | A_BOLD, value = COLOR_PAIR(PAIR_O) | A_BOLD;
+        if (settingsRow == 0) put(win, 3, 0, "> Difficulty: ", choice);
+        else put(win, 3, 0, "  Difficulty: ");
         
         std::string dStr;
         switch(difficulty) {
@@ -146,60 +148,64 @@ public:
             case DIFF_HARD: dStr = "Hard (Smart)"; break;
             case DIFF_IMPOSSIBLE: dStr = "Impossible (Minimax)"; break;
         }
-        if (settingsRow == 0) std::cout << "< " << COLOR_CYAN << dStr << COLOR_RESET << " >";
-        else std::cout << dStr;
+        if (settingsRow == 0) {
+            put(win, 3, 14, "< ");
+            put(win, 3, 16, dStr, value);
+            put(win, 3, 16 + dStr.size(), " >");
+        } else {
+            put(win, 3, 14, dStr);
+        }
 
-        moveTo(5, 0);
-        if (settingsRow == 1) std::cout << COLOR_YELLOW << "> First Move: " << COLOR_RESET;
-        else std::cout << "  First Move: ";
+        if (settingsRow == 1) put(win, 5, 0, "> First Move: ", choice);
+        else put(win, 5, 0, "  First Move: ");
         
         std::string pStr = playerStarts ? "Player (X)" : "Bot (O)";
-        if (settingsRow == 1) std::cout << "< " << COLOR_CYAN << pStr << COLOR_RESET << " >";
-        else std::cout << pStr;
+        if (settingsRow == 1) {
+            put(win, 5, 14, "< ");
+            put(win, 5, 16, pStr, value);
+            put(win, 5, 16 + pStr.size(), " >");
+        } else {
+            put(win, 5, 14, pStr);
+        }
 
-        moveTo(8, 10);
-        if (settingsRow == 2) std::cout << BG_SELECTED << " [ START GAME ] " << COLOR_RESET;
-        else std::cout << " [ START GAME ] ";
+        put(win, 8, 10, " [ START GAME ] ", settingsRow == 2 ? COLOR_PAIR(PAIR_SELECTED) : 0);
 
-        moveTo(11, 0);
-        std::cout << COLOR_GRID << "Arrows: Move/Change | Enter: Select" << COLOR_RESET;
-        std::cout << std::flush;
+        put(win, 11, 0, "Arrows: Move/Change | Enter: Select", COLOR_PAIR(PAIR_GRID));
     }
 
-    void drawGame() {
-        struct winsize w;
-        ioctl(STDOUT_FILENO, TIOCGWINSZ, &w);
-        boardRow = (w.ws_row - 16) / 2;
-        boardCol = (w.ws_col - 25) / 2;
-        if (boardRow < 1) boardRow = 1;
-        if (boardCol < 1) boardCol = 1;
-
-        std::cout << "\033[2J"; 
-        moveTo(-2, 6); std::cout << COLOR_CYAN << "TIC-TAC-TOE" << COLOR_RESET;
-        moveTo(0, 0); std::cout << COLOR_GRID << "┌───────┬───────┬───────┐" << COLOR_RESET;
+    void drawGame(WINDOW* win) {
+        boardRow = (getmaxy(win) - 16) / 2;
+        boardCol = (getmaxx(win) - 25) / 2;
+        if (boardRow < 2) boardRow = 2;
+        if (boardCol < 10) boardCol = 10;
+
+        const int grid = COLOR_PAIR(PAIR_GRID);
+        werase(win);
+        put(win, -2, 6, "TIC-TAC-TOE", COLOR_PAIR(PAIR_O) | A_BOLD);
+        put(win, 0, 0, "┌───────┬───────┬───────┐", grid);
         
         for (int i = 0; i < 3; ++i) {
             int startRow = 1 + i * 4; 
             for (int line = 0; line < 3; line++) {
-                moveTo(startRow + line, 0);
-                std::cout << COLOR_GRID << "│" << COLOR_RESET; 
+                put(win, startRow + line, 0, "│", grid);
                 for (int j = 0; j < 3; j++) {
-                    printCellLine(i, j, line);
-                    std::cout << COLOR_GRID << "│" << COLOR_RESET; 
+                    printCellLine(win, i, j, line);
+                    addText(win, "│", grid);
                 }
             }
-            moveTo(startRow + 3, 0);
-            std::cout << COLOR_GRID;
-            if (i == 2) std::cout << "└───────┴───────┴───────┘";
-            else        std::cout << "├───────┼───────┼───────┤";
-            std::cout << COLOR_RESET;
+            if (i == 2) put(win, startRow + 3, 0, "└───────┴───────┴───────┘", grid);
+            else        put(win, startRow + 3, 0, "├───────┼───────┼───────┤", grid);
         }
 
-        moveTo(14, 0); 
-        std::cout << "\033[" << (boardCol) << "G" << message;
-        moveTo(16, -10);
-        std::cout << "\033[" << (boardCol - 10) << "G" << COLOR_GRID << "[ARROWS] Move [ENTER] Select [Q] Menu" << COLOR_RESET;
-        std::cout << std::flush;
+        put(win, 14, 0, message, messagePair ? COLOR_PAIR(messagePair) | A_BOLD : 0);
+        put(win, 16, -10, "[ARROWS] Move [ENTER] Select [Q] Menu", grid);
+    }
+
+    void render(WINDOW* win) {
+        getbegyx(win, originY, originX);
+        if (currentState == STATE_MENU) drawMenu(win);
+        else if (currentState == STATE_SETTINGS) drawSettings(win);
+        else drawGame(win);
     }
 
     char checkWinnerSim(char b[3][3]) {
@@ -300,17 +306,17 @@ public:
     void handleGameEndCheck() {
         char winner = checkWinnerSim(board);
         if (winner != 0) {
-            if (vsComputer && winner == 'O') message = std::string(COLOR_CYAN) + "Bot Wins! Press key." + std::string(COLOR_RESET);
-            else if (winner == 'X') message = std::string(COLOR_RED) + "Player X Wins! Press key." + std::string(COLOR_RESET);
-            else message = std::string(COLOR_CYAN) + "Player O Wins! Press key." + std::string(COLOR_RESET);
+            if (vsComputer && winner == 'O') setMessage("Bot Wins! Press key.", PAIR_O);
+            else if (winner == 'X') setMessage("Player X Wins! Press key.", PAIR_X);
+            else setMessage("Player O Wins! Press key.", PAIR_O);
             running = false;
         } else if (!isMovesLeft(board)) {
-            message = "It's a Draw! Press key.";
+            setMessage("It's a Draw! Press key.", 0);
             running = false;
         } else {
             currentPlayer = (currentPlayer == 'X' ? 'O' : 'X');
-            if (currentPlayer == 'X') message = std::string(COLOR_RED) + "Player X's turn" + std::string(COLOR_RESET);
-            else message = std::string(COLOR_CYAN) + "Bot O is thinking..." + std::string(COLOR_RESET);
+            if (currentPlayer == 'X') setMessage("Player X's turn", PAIR_X);
+            else setMessage("Bot O is thinking...", PAIR_O);
         }
     }
 
@@ -318,16 +324,16 @@ public:
         if (board[selX][selY] == ' ') {
             board[selX][selY] = currentPlayer;
             handleGameEndCheck();
-            if (running && vsComputer && currentPlayer == 'O') {
-                drawGame();
-                usleep(300000); 
-                computerMove();
-            }
+            if (running && vsComputer && currentPlayer == 'O') botDelayMs = 300;
         }
     }
 
+    // Mouse coordinates are the terminal's; the board is placed inside the
+    // host's window.
     void handleMouse(int mx, int my) {
         if (currentState != STATE_GAME) return;
+        mx -= originX;
+        my -= originY;
         int startX = boardCol + 1; 
         int startY = boardRow + 1; 
         if (mx < startX || mx > startX + 24 || my < startY || my > startY + 11) return;
@@ -341,88 +347,97 @@ public:
         }
     }
 
-    void run() {
-        char buf[6];
-        while (!exitProgram) {
-            if (currentState == STATE_MENU) {
-                drawMenu();
-                if (read(STDIN_FILENO, buf, 1) > 0) {
-                    if (buf[0] == '\033') {
-                        read(STDIN_FILENO, buf+1, 2);
-                        if (buf[1] == '[') {
-                            if (buf[2] == 'A') menuSelection = (menuSelection - 1 + 3) % 3;
-                            else if (buf[2] == 'B') menuSelection = (menuSelection + 1) % 3;
-                        }
-                    } else if (buf[0] == '\n' || buf[0] == '\r' || buf[0] == ' ') {
-                        if (menuSelection == 0) { 
-                            vsComputer = true; 
-                            currentState = STATE_SETTINGS;
-                        } else if (menuSelection == 1) { 
-                            vsComputer = false; 
-                            currentState = STATE_GAME; 
-                            resetBoard(); 
-                        } else if (menuSelection == 2) { 
-                            exitProgram = true; 
-                        }
-                    } else if (buf[0] == 'q') exitProgram = true;
-                }
-            } 
-            else if (currentState == STATE_SETTINGS) {
-                drawSettings();
-                if (read(STDIN_FILENO, buf, 1) > 0) {
-                    if (buf[0] == '\033') {
-                        read(STDIN_FILENO, buf+1, 2);
-                        if (buf[1] == '[') {
-                            if (buf[2] == 'A') settingsRow = (settingsRow - 1 + 3) % 3;
-                            else if (buf[2] == 'B') settingsRow = (settingsRow + 1) % 3;
-                            else if (buf[2] == 'C') {
-                                if(settingsRow == 0) difficulty = (Difficulty)((difficulty + 1) % 4);
-                                if(settingsRow == 1) playerStarts = !playerStarts;
-                            }
-                            else if (buf[2] == 'D') {
-                                if(settingsRow == 0) difficulty = (Difficulty)((difficulty - 1 + 4) % 4);
-                                if(settingsRow == 1) playerStarts = !playerStarts;
-                            }
-                        }
-                    } else if (buf[0] == '\n' || buf[0] == '\r' || buf[0] == ' ') {
-                        if (settingsRow == 2) {
-                            currentState = STATE_GAME;
-                            resetBoard();
-                        }
-                    } else if (buf[0] == 'q') currentState = STATE_MENU;
+    // False when the player leaves from the main menu.
+    bool handleKey(int ch) {
+        bool confirm = ch == '\n' || ch == '\r' || ch == ' ' || ch == KEY_ENTER;
+        if (currentState == STATE_MENU) {
+            if (ch == KEY_UP) menuSelection = (menuSelection - 1 + 3) % 3;
+            else if (ch == KEY_DOWN) menuSelection = (menuSelection + 1) % 3;
+            else if (confirm) {
+                if (menuSelection == 0) { 
+                    vsComputer = true; 
+                    currentState = STATE_SETTINGS;
+                } else if (menuSelection == 1) { 
+                    vsComputer = false; 
+                    currentState = STATE_GAME; 
+                    resetBoard(); 
+                } else if (menuSelection == 2) { 
+                    exitProgram = true; 
                 }
+            } else if (ch == 'q') exitProgram = true;
+        } 
+        else if (currentState == STATE_SETTINGS) {
+            if (ch == KEY_UP) settingsRow = (settingsRow - 1 + 3) % 3;
+            else if (ch == KEY_DOWN) settingsRow = (settingsRow + 1) % 3;
+            else if (ch == KEY_RIGHT) {
+                if(settingsRow == 0) difficulty = (Difficulty)((difficulty + 1) % 4);
+                if(settingsRow == 1) playerStarts = !playerStarts;
             }
-            else if (currentState == STATE_GAME) {
-                drawGame();
-                if (read(STDIN_FILENO, buf, 1) > 0) {
-                    if (!running) { currentState = STATE_MENU; continue; }
-                    if (buf[0] == 'q') { currentState = STATE_MENU; continue; }
-                    if (vsComputer && currentPlayer == 'O') continue;
-
-                    if (buf[0] == '\n' || buf[0] == '\r' || buf[0] == ' ') {
-                        makeMove();
-                    } else if (buf[0] == '\033') {
-                        read(STDIN_FILENO, buf+1, 2); 
-                        if (buf[1] == '[') {
-                            if (buf[2] == 'A') selX = (selX - 1 + 3) % 3; 
-                            else if (buf[2] == 'B') selX = (selX + 1) % 3;
-                            else if (buf[2] == 'C') selY = (selY + 1) % 3;
-                            else if (buf[2] == 'D') selY = (selY - 1 + 3) % 3;
-                            else if (buf[2] == 'M') {
-                                read(STDIN_FILENO, buf+3, 3);
-                                handleMouse((unsigned char)buf[4]-32, (unsigned char)buf[5]-32);
-                            }
-                        }
-                    }
-                }
+            else if (ch == KEY_LEFT) {
+                if(settingsRow == 0) difficulty = (Difficulty)((difficulty - 1 + 4) % 4);
+                if(settingsRow == 1) playerStarts = !playerStarts;
             }
+            else if (confirm) {
+                if (settingsRow == 2) {
+                    currentState = STATE_GAME;
+                    resetBoard();
+                }
+            } else if (ch == 'q') currentState = STATE_MENU;
+        }
+        else if (currentState == STATE_GAME) {
+            if (!running) { currentState = STATE_MENU; return true; }
+            if (ch == 'q') { currentState = STATE_MENU; return true; }
+            if (vsComputer && currentPlayer == 'O') return true;
+
+            MEVENT event;
+            if (confirm) makeMove();
+            else if (ch == KEY_UP) selX = (selX - 1 + 3) % 3; 
+            else if (ch == KEY_DOWN) selX = (selX + 1) % 3;
+            else if (ch == KEY_RIGHT) selY = (selY + 1) % 3;
+            else if (ch == KEY_LEFT) selY = (selY - 1 + 3) % 3;
+            else if (ch == KEY_MOUSE && getmouse(&event) == OK && (event.bstate & (BUTTON1_PRESSED | BUTTON1_CLICKED)))
+                handleMouse(event.x, event.y);
         }
+        return !exitProgram;
     }
 };
 
+Game game;
+
+void init() {
+    game.enter();
+    mousemask(BUTTON1_PRESSED | BUTTON1_CLICKED, nullptr);
+    mouseinterval(0);
+
+    if (has_colors()) {
+        init_pair(PAIR_X, COLOR_RED, COLOR_BLACK);
+        init_pair(PAIR_O, COLOR_CYAN, COLOR_BLACK);
+        init_pair(PAIR_TITLE, COLOR_GREEN, COLOR_BLACK);
+        init_pair(PAIR_CHOICE, COLOR_YELLOW, COLOR_BLACK);
+        // Bright black where the terminal has sixteen colors.
+        init_pair(PAIR_GRID, COLORS >= 16 ? 8 : COLOR_WHITE, COLOR_BLACK);
+        init_pair(PAIR_SELECTED, COLOR_BLACK, COLOR_WHITE);
+        init_pair(PAIR_X_SELECTED, COLOR_RED, COLOR_WHITE);
+        init_pair(PAIR_O_SELECTED, COLOR_CYAN, COLOR_WHITE);
+    }
+}
+
+bool handleKey(int ch) { return game.handleKey(ch); }
+void tick() { game.tick(); }
+void render(WINDOW* win) { game.render(win); }
+int tickInterval() { return game.tickInterval(); }
+
+void teardown() {
+    mousemask(0, nullptr);
+}
+
+const GamePlugin plugin = {
+    GAME_PLUGIN_ABI_VERSION, "tictactoe", 0, init, handleKey, tick, render, teardown, tickInterval,
+};
+
+extern "C" const GamePlugin* game_plugin() { return &plugin; }
+
 int main() {
-    TermConfig tc;
-    Game game;
-    game.run();
-    return 0;
+    setlocale(LC_ALL, "");
+    return runGamePlugin(&plugin);
 }
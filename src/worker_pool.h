@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Persistent worker threads that pull task indices from a shared counter, so
+// a task that finishes early frees its thread for the next one. The threads
+// outlive each run(), so state kept per worker stays warm from one batch to
+// the next. The calling thread takes tasks too, as worker 0: a pool of n
+// threads starts n - 1 workers.
+//
+// Scratch state belongs to the caller, one slot per worker, never in
+// thread_local variables. Games run as plugins inside the launcher, on its
+// thread; a thread_local with a destructor touched there pins the plugin in
+// memory, and dlclose no longer unmaps it.
+class WorkerPool {
+    std::vector<std::thread> workers;
+    std::mutex mtx;
+    std::condition_variable startCv, doneCv;
+    uint64_t generation = 0;
+    int pending = 0;
+    bool stopping = false;
+
+    std::atomic<int> next{0};
+    int taskCount = 0;
+    const std::function<void(int, int)>* task = nullptr;
+
+    void drain(int worker) {
+        for (int i; (i = next++) < taskCount;) (*task)(i, worker);
+    }
+
+    void workerLoop(int worker) {
+        uint64_t seen = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                startCv.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+            }
+            drain(worker);
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                if (--pending == 0) doneCv.notify_one();
+            }
+        }
+    }
+
+public:
+    explicit WorkerPool(int threads) {
+        for (int t = 1; t < threads; t++) workers.emplace_back(&WorkerPool::workerLoop, this, t);
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopping = true;
+        }
+        startCv.notify_all();
+        for (auto& t : workers) t.join();
+    }
+
+    int size() const { return workers.size() + 1; }
+
+    // Calls fn(task, worker) for every task from 0 to count - 1 across the
+    // pool, where worker (0 to size() - 1) names the thread it runs on, and
+    // returns once all of them have.
+    void run(int count, const std::function<void(int, int)>& fn) {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            task = &fn;
+            taskCount = count;
+            next = 0;
+            pending = workers.size();
+            generation++;
+        }
+        startCv.notify_all();
+        drain(0);
+        std::unique_lock<std::mutex> lock(mtx);
+        doneCv.wait(lock, [&] { return pending == 0; });
+    }
+};